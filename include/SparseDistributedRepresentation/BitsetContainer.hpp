@@ -0,0 +1,220 @@
+#pragma once
+
+#include <array>
+#include <assert.h>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+#include "SparseDistributedRepresentation/SDRElem.hpp"
+
+namespace sparse_distributed_representation {
+
+namespace bitset_container_objs {
+
+// the bitset doesn't store elements (only their presence), so the iterator dereferences to an element by value.
+// operator-> points into the iterator itself
+template<typename container_t>
+class ConstIterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = typename container_t::value_type;
+        using reference = value_type;
+        using pointer = const value_type*;
+
+        ConstIterator() : container(nullptr), elem() {}
+
+        ConstIterator(const container_t* container, std::size_t index)
+            : container(container), elem(static_cast<typename value_type::id_type>(index)) {}
+
+        reference operator*() const { return elem; }
+        pointer operator->() const { return &elem; }
+
+        ConstIterator& operator++() { elem = value_type(container->next_set(index() + 1)); return *this; }
+        ConstIterator operator++(int) { ConstIterator tmp = *this; ++(*this); return tmp; }
+        ConstIterator& operator--() { elem = value_type(container->prev_set(index())); return *this; }
+        ConstIterator operator--(int) { ConstIterator tmp = *this; --(*this); return tmp; }
+
+        bool operator==(const ConstIterator& o) const { return elem.id() == o.elem.id(); }
+        bool operator!=(const ConstIterator& o) const { return elem.id() != o.elem.id(); }
+
+        std::size_t index() const { return static_cast<std::size_t>(elem.id()); }
+
+    private:
+        const container_t* container;
+        value_type elem;
+};
+
+} // namespace bitset_container_objs
+
+// stores the elements as a fixed size bitset, instead of as a list of ids.
+// this is more compact and faster than a list of ids if the SDR is dense enough (roughly 1/32 of the universe or more).
+// if both operands of an op are BitsetContainers, then SDR computes the op word-wise.
+//
+// it behaves like a std::set (it can lower_bound, and insert and erase anywhere).
+// iterators are not invalidated by insert or erase, except for the erased element.
+//
+// Only the necessary functions have been implemented (for use in SDR).
+//
+// @tparam universe ids must be in the range [0, universe)
+template<typename SDRElem_t, std::size_t universe>
+class BitsetContainer {
+    static_assert(std::is_same_v<typename SDRElem_t::data_type, EmptyData>, "BitsetContainer can't store data");
+    static_assert(universe > 0);
+
+    public:
+        using word_type = std::uint64_t;
+        static constexpr std::size_t word_bits = 64;
+        static constexpr std::size_t word_count = (universe + word_bits - 1) / word_bits;
+        static constexpr std::size_t universe_size = universe;
+
+        using size_type = std::size_t;
+        using value_type = SDRElem_t;
+        using const_iterator = bitset_container_objs::ConstIterator<BitsetContainer>;
+        using iterator = const_iterator;
+        using reference = SDRElem_t;
+        using const_reference = SDRElem_t;
+        using pointer = const SDRElem_t*;
+        using const_pointer = const SDRElem_t*;
+
+        BitsetContainer() : words_(), count(0) {}
+
+        size_type size() const { return count; }
+        bool empty() const { return count == 0; }
+
+        const_iterator begin() const { return const_iterator(this, next_set(0)); }
+        const_iterator end() const { return const_iterator(this, universe); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+
+        const_iterator lower_bound(typename SDRElem_t::id_type id) const {
+            if constexpr(std::is_signed_v<typename SDRElem_t::id_type>) {
+                if (id < 0) return begin();
+            }
+            return const_iterator(this, next_set(static_cast<std::size_t>(id)));
+        }
+
+        const_iterator lower_bound(const SDRElem_t& elem) const { return lower_bound(elem.id()); }
+
+        const_iterator upper_bound(typename SDRElem_t::id_type id) const {
+            if constexpr(std::is_signed_v<typename SDRElem_t::id_type>) {
+                if (id < 0) return begin();
+            }
+            return const_iterator(this, next_set(static_cast<std::size_t>(id) + 1));
+        }
+
+        const_iterator upper_bound(const SDRElem_t& elem) const { return upper_bound(elem.id()); }
+
+        const_iterator insert(const SDRElem_t& elem) {
+            auto index = static_cast<std::size_t>(elem.id());
+            assert(index < universe && "id out of range for BitsetContainer");
+            word_type& word = words_[index / word_bits];
+            word_type bit = word_type(1) << (index % word_bits);
+            if (!(word & bit)) {
+                word |= bit;
+                ++count;
+            }
+            return const_iterator(this, index);
+        }
+
+        // the position is only a hint, same as std::set
+        const_iterator insert(const_iterator, const SDRElem_t& elem) { return insert(elem); }
+
+        const_iterator erase(const_iterator pos) {
+            auto index = pos.index();
+            assert(index < universe);
+            word_type& word = words_[index / word_bits];
+            word_type bit = word_type(1) << (index % word_bits);
+            if (word & bit) {
+                word &= ~bit;
+                --count;
+            }
+            return const_iterator(this, next_set(index + 1));
+        }
+
+        const_iterator erase(const_iterator first, const_iterator last) {
+            while (first != last) {
+                first = erase(first);
+            }
+            return last;
+        }
+
+        void clear() {
+            words_.fill(0);
+            count = 0;
+        }
+
+        // index of the first element at or after index, or the universe size if there isn't one
+        std::size_t next_set(std::size_t index) const {
+            if (index >= universe) return universe;
+            std::size_t word_index = index / word_bits;
+            word_type word = words_[word_index] & (~word_type(0) << (index % word_bits));
+            while (true) {
+                if (word) {
+                    return word_index * word_bits + __builtin_ctzll(word);
+                }
+                if (++word_index == word_count) return universe;
+                word = words_[word_index];
+            }
+        }
+
+        // index of the last element before index. there must be one
+        std::size_t prev_set(std::size_t index) const {
+            assert(index > 0);
+            --index;
+            std::size_t word_index = index / word_bits;
+            std::size_t shift = word_bits - 1 - index % word_bits;
+            word_type word = (words_[word_index] << shift) >> shift;
+            while (true) {
+                if (word) {
+                    return word_index * word_bits + word_bits - 1 - __builtin_clzll(word);
+                }
+                assert(word_index != 0);
+                word = words_[--word_index];
+            }
+        }
+
+        const std::array<word_type, word_count>& words() const { return words_; }
+
+        // this = op(a, b), word-wise
+        template<typename A, typename B, typename Op>
+        void assign_words(const A& a, const B& b, Op op) {
+            static_assert(A::universe_size == universe_size && B::universe_size == universe_size, "BitsetContainer universe mismatch");
+            count = 0;
+            for (std::size_t i = 0; i < word_count; ++i) {
+                words_[i] = op(a.words()[i], b.words()[i]);
+                count += __builtin_popcountll(words_[i]);
+            }
+        }
+
+        // the number of bits in op(this, o)
+        template<typename B, typename Op>
+        size_type count_words(const B& o, Op op) const {
+            static_assert(B::universe_size == universe_size, "BitsetContainer universe mismatch");
+            size_type r = 0;
+            for (std::size_t i = 0; i < word_count; ++i) {
+                r += __builtin_popcountll(op(words_[i], o.words()[i]));
+            }
+            return r;
+        }
+
+        // calls visitor(id) for each bit in op(this, o), in ascending order
+        template<typename B, typename Op, typename Visitor>
+        void visit_words(const B& o, Op op, Visitor visitor) const {
+            static_assert(B::universe_size == universe_size, "BitsetContainer universe mismatch");
+            for (std::size_t i = 0; i < word_count; ++i) {
+                word_type word = op(words_[i], o.words()[i]);
+                while (word) {
+                    visitor(i * word_bits + __builtin_ctzll(word));
+                    word &= word - 1;
+                }
+            }
+        }
+
+    private:
+        std::array<word_type, word_count> words_;
+        size_type count;
+};
+
+} // namespace sparse_distributed_representation
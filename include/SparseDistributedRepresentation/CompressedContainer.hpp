@@ -0,0 +1,249 @@
+#pragma once
+
+#include <algorithm>
+#include <assert.h>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include "SparseDistributedRepresentation/SDRElem.hpp"
+
+namespace sparse_distributed_representation {
+
+namespace compressed_container_objs {
+
+// each id is stored as its difference from the previous id, as a LEB128 varint:
+// 7 bits per byte, and the high bit is set on every byte except the last
+template<typename u_t>
+void write_varint(std::vector<std::uint8_t>& bytes, u_t val) {
+    while (val >= 0x80) {
+        bytes.push_back(static_cast<std::uint8_t>(val | 0x80));
+        val >>= 7;
+    }
+    bytes.push_back(static_cast<std::uint8_t>(val));
+}
+
+// decodes the varint at pos, and moves pos past it
+template<typename u_t>
+u_t read_varint(const std::uint8_t*& pos) {
+    u_t r = 0;
+    unsigned shift = 0;
+    while (true) {
+        std::uint8_t b = *pos++;
+        r |= static_cast<u_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) return r;
+        shift += 7;
+    }
+}
+
+// the container doesn't store elements (only the encoded ids), so the iterator dereferences to an element by value.
+// operator-> points into the iterator itself
+template<typename container_t>
+class ConstIterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = typename container_t::value_type;
+        using reference = value_type;
+        using pointer = const value_type*;
+        using u_type = typename container_t::u_type;
+
+        ConstIterator() : container(nullptr), offset(0), next_offset(0), u(0), elem() {}
+
+        // offset is the position of the element's varint, and u is the element's (unsigned) id
+        ConstIterator(const container_t* container, std::size_t offset, u_type u)
+            : container(container), offset(offset), next_offset(offset), u(u), elem(container_t::from_u(u)) {
+            if (offset != container->encoded().size()) {
+                const std::uint8_t* p = data() + offset;
+                read_varint<u_type>(p);
+                next_offset = static_cast<std::size_t>(p - data());
+            }
+        }
+
+        reference operator*() const { return elem; }
+        pointer operator->() const { return &elem; }
+
+        ConstIterator& operator++() {
+            offset = next_offset;
+            if (offset != container->encoded().size()) {
+                const std::uint8_t* p = data() + offset;
+                u += read_varint<u_type>(p);
+                next_offset = static_cast<std::size_t>(p - data());
+                elem = value_type(container_t::from_u(u));
+            }
+            return *this;
+        }
+
+        ConstIterator operator++(int) { ConstIterator tmp = *this; ++(*this); return tmp; }
+
+        ConstIterator& operator--() {
+            assert(offset != 0);
+            if (offset == container->encoded().size()) {
+                // the end iterator already has the last id
+                u = container->last_u();
+            } else {
+                const std::uint8_t* p = data() + offset;
+                u -= read_varint<u_type>(p);
+            }
+            // the previous varint ends just before this one. its first byte follows a byte without the high bit set
+            next_offset = offset;
+            --offset;
+            while (offset != 0 && (data()[offset - 1] & 0x80)) --offset;
+            elem = value_type(container_t::from_u(u));
+            return *this;
+        }
+
+        ConstIterator operator--(int) { ConstIterator tmp = *this; --(*this); return tmp; }
+
+        bool operator==(const ConstIterator& o) const { return offset == o.offset; }
+        bool operator!=(const ConstIterator& o) const { return offset != o.offset; }
+
+    private:
+        const std::uint8_t* data() const { return container->encoded().data(); }
+
+        const container_t* container;
+        std::size_t offset;
+        std::size_t next_offset;
+        u_type u;
+        value_type elem;
+};
+
+} // namespace compressed_container_objs
+
+// stores the ids as delta encoded varints, which is typically 1 or 2 bytes per id instead of sizeof(id_type).
+// this is meant for large collections of stored SDRs, which are mostly read and rarely modified.
+// the ids are decoded as a stream while iterating, so the SDR ops never need to decompress the whole container.
+// every few elements the byte offset is recorded, which lets lower_bound skip ahead.
+//
+// elements can only be appended (inserted at the end), which is how SDR ops build their results.
+// the inplace ops (andi, ori, etc.) replace the container instead of modifying it.
+//
+// it behaves like a std::set (it can lower_bound), but it can't erase.
+//
+// Only the necessary functions have been implemented (for use in SDR).
+template<typename SDRElem_t>
+class CompressedContainer {
+    using id_type = typename SDRElem_t::id_type;
+    static_assert(std::is_integral_v<id_type>, "CompressedContainer ids must be integers");
+    static_assert(std::is_same_v<typename SDRElem_t::data_type, EmptyData>, "CompressedContainer can't store data");
+
+    public:
+        using u_type = std::make_unsigned_t<id_type>;
+
+        // an offset is recorded for every this many elements
+        static constexpr std::size_t skip_interval = 64;
+
+        using size_type = std::size_t;
+        using value_type = SDRElem_t;
+        using const_iterator = compressed_container_objs::ConstIterator<CompressedContainer>;
+        using iterator = const_iterator;
+        using reference = SDRElem_t;
+        using const_reference = SDRElem_t;
+        using pointer = const SDRElem_t*;
+        using const_pointer = const SDRElem_t*;
+
+        CompressedContainer() : last(0), count(0) {}
+
+        size_type size() const { return count; }
+        bool empty() const { return count == 0; }
+
+        const_iterator begin() const { return empty() ? end() : const_iterator(this, 0, skips.front().u); }
+        const_iterator end() const { return const_iterator(this, bytes.size(), last); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+
+        const_iterator lower_bound(id_type id) const {
+            u_type u = to_u(id);
+            // start from the last recorded offset at or before the id
+            auto skip = std::upper_bound(skips.begin(), skips.end(), u, [](u_type val, const Skip& s) { return val < s.u; });
+            if (skip == skips.begin()) return begin();
+            --skip;
+            const_iterator it(this, skip->offset, skip->u);
+            const_iterator e = end();
+            while (it != e && to_u(it->id()) < u) ++it;
+            return it;
+        }
+
+        const_iterator lower_bound(const SDRElem_t& elem) const { return lower_bound(elem.id()); }
+
+        const_iterator upper_bound(id_type id) const {
+            auto it = lower_bound(id);
+            if (it != end() && it->id() == id) ++it;
+            return it;
+        }
+
+        const_iterator upper_bound(const SDRElem_t& elem) const { return upper_bound(elem.id()); }
+
+        // the element must be after every element in this
+        const_iterator insert(const SDRElem_t& elem) {
+            u_type u = to_u(elem.id());
+            assert((count == 0 || u > last) && "CompressedContainer can only append");
+            std::size_t offset = bytes.size();
+            if (count % skip_interval == 0) {
+                skips.push_back(Skip{offset, u});
+            }
+            compressed_container_objs::write_varint(bytes, count == 0 ? u : static_cast<u_type>(u - last));
+            last = u;
+            ++count;
+            return const_iterator(this, offset, u);
+        }
+
+        // the position must be the end
+        const_iterator insert([[maybe_unused]] const_iterator pos, const SDRElem_t& elem) {
+            assert(pos == end() && "CompressedContainer can only append");
+            return insert(elem);
+        }
+
+        void clear() {
+            bytes.clear();
+            skips.clear();
+            last = 0;
+            count = 0;
+        }
+
+        void shrink_to_fit() {
+            bytes.shrink_to_fit();
+            skips.shrink_to_fit();
+        }
+
+        // approximate number of bytes used
+        std::size_t memory_usage() const {
+            return sizeof(*this) + bytes.capacity() * sizeof(std::uint8_t) + skips.capacity() * sizeof(Skip);
+        }
+
+        const std::vector<std::uint8_t>& encoded() const { return bytes; }
+
+        // the unsigned id of the last element
+        u_type last_u() const { return last; }
+
+        // ids are mapped to unsigned values which keep the same order
+        static u_type to_u(id_type id) {
+            if constexpr(std::is_signed_v<id_type>) {
+                return static_cast<u_type>(id) ^ (u_type(1) << (sizeof(u_type) * 8 - 1));
+            } else {
+                return id;
+            }
+        }
+
+        static id_type from_u(u_type u) {
+            if constexpr(std::is_signed_v<id_type>) {
+                return static_cast<id_type>(u ^ (u_type(1) << (sizeof(u_type) * 8 - 1)));
+            } else {
+                return u;
+            }
+        }
+
+    private:
+        struct Skip {
+            std::size_t offset;
+            u_type u;
+        };
+
+        std::vector<std::uint8_t> bytes;
+        std::vector<Skip> skips;
+        u_type last;
+        size_type count;
+};
+
+} // namespace sparse_distributed_representation
@@ -0,0 +1,365 @@
+#pragma once
+
+#include <algorithm>
+#include <assert.h>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "SparseDistributedRepresentation/SDR.hpp"
+#include "SparseDistributedRepresentation/IDContiguousContainer.hpp"
+#include "SparseDistributedRepresentation/SDRRange.hpp"
+
+namespace sparse_distributed_representation {
+
+namespace compressed_matrix_objs {
+
+// gives raw pointers as the iterators for id_contiguous_container_objs::ConstIterator
+template<typename T>
+struct ConstSpan {
+    using iterator = const T*;
+    using const_iterator = const T*;
+};
+
+} // namespace compressed_matrix_objs
+
+/**
+ * A read-only view of a row in a CompressedMatrix.
+ * Like IDContiguousContainer, the ids and the datas are in separate arrays, but they are owned by the matrix.
+ *
+ * Only the const functions are implemented (for use in SDR). The SDR ops which don't modify the SDR work on a view,
+ * but ops which build an SDR need the result container to be given, e.g. row.ande<SDRElem_t, std::vector<SDRElem_t>>(arg).
+ */
+template<typename SDRElem_t>
+class RowView {
+    private:
+        using id_t = typename SDRElem_t::id_type;
+        using data_t = typename SDRElem_t::data_type;
+        using ids_span = compressed_matrix_objs::ConstSpan<id_t>;
+        using datas_span = compressed_matrix_objs::ConstSpan<data_t>;
+
+        const id_t* ids_;
+        const data_t* datas_;
+        std::size_t n;
+
+    public:
+        using size_type = std::size_t;
+        using const_iterator = id_contiguous_container_objs::ConstIterator<SDRElem_t, ids_span, datas_span>;
+        using iterator = const_iterator;
+        using reference = id_contiguous_container_objs::SDRElemConstReference<SDRElem_t>;
+        using const_reference = reference;
+        using pointer = const_iterator;
+        using const_pointer = const_iterator;
+        using value_type = SDRElem_t;
+
+        RowView() : ids_(nullptr), datas_(nullptr), n(0) {}
+        RowView(const id_t* ids, const data_t* datas, size_type n) : ids_(ids), datas_(datas), n(n) {}
+
+        size_type size() const { return n; }
+        bool empty() const { return n == 0; }
+
+        const_iterator begin() const { return const_iterator(ids_, datas_); }
+        const_iterator end() const { return const_iterator(ids_ + n, datas_ + n); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+
+        const_reference operator[](size_type pos) const { return reference(ids_ + pos, datas_ + pos); }
+
+        const id_t* ids() const { return ids_; }
+};
+
+namespace intersect_kernels {
+
+template<typename id_t, typename data_t>
+struct contiguous_ids<RowView<SDRElem<id_t, data_t>>> : std::true_type {
+    using id_type = id_t;
+
+    static const id_t* ids(const RowView<SDRElem<id_t, data_t>>& c) { return c.ids(); }
+};
+
+} // namespace intersect_kernels
+
+/**
+ * A sparse matrix, stored flat in compressed rows (or columns; for variable naming, assume row major).
+ *
+ *      major_ids -> the ids of the rows which have elements, ascending
+ *      major_ptr -> row i has the elements from major_ptr[i] to major_ptr[i + 1]
+ *      minor_ids -> the column of each element (aka col_idx)
+ *      values    -> the data of each element
+ *
+ * Unlike a classic CSR matrix, empty rows aren't stored, so the row ids can be sparse like in a nested matrix
+ * (SDR<SDRElem<id, SDR<...>>>). All of the elements are in the same few arrays, instead of a heap allocation per row.
+ *
+ * @tparam SDRElem_t the elements in each row. the id is the column.
+ * @tparam major_id_t the id type of the rows.
+ */
+template<typename SDRElem_t = SDRElem<int, EmptyData>, typename major_id_t = typename SDRElem_t::id_type>
+class CompressedMatrix {
+    public:
+        using value_type = SDRElem_t;
+        using id_type = typename SDRElem_t::id_type;
+        using data_type = typename SDRElem_t::data_type;
+        using major_id_type = major_id_t;
+        using size_type = std::size_t;
+        using row_type = SDR<SDRElem_t, RowView<SDRElem_t>>;
+
+        CompressedMatrix() : major_ptr{0} {}
+
+        // converts from a nested matrix
+        template<typename MatElem_t, typename mat_c_t>
+        explicit CompressedMatrix(const SDR<MatElem_t, mat_c_t>& nested) : CompressedMatrix() {
+            for (const auto& row : nested) push_back(row.id(), row.data());
+        }
+
+        // converts to a nested matrix
+        template<typename matrix_t = SDR<SDRElem<major_id_t, SDR<SDRElem_t>>>>
+        matrix_t to_nested() const {
+            using row_elem_t = typename matrix_t::value_type;
+            using nested_row_t = typename row_elem_t::data_type;
+            matrix_t ret;
+            nary_ops::Appender<matrix_t> append_row(ret);
+            for (size_type i = 0; i < major_ids.size(); ++i) {
+                row_type r = row(i);
+                append_row(row_elem_t(major_ids[i], nested_row_t(r.cbegin(), r.cend())));
+            }
+            return ret;
+        }
+
+        // the number of rows with elements
+        size_type majors() const { return major_ids.size(); }
+        // the number of elements
+        size_type nnz() const { return minor_ids.size(); }
+        bool empty() const { return major_ids.empty(); }
+
+        const std::vector<major_id_t>& get_major_ids() const { return major_ids; }
+        const std::vector<size_type>& get_major_ptr() const { return major_ptr; }
+        const std::vector<id_type>& get_minor_ids() const { return minor_ids; }
+        const std::vector<data_type>& get_values() const { return values; }
+
+        void reserve(size_type majors, size_type nnz) {
+            major_ids.reserve(majors);
+            major_ptr.reserve(majors + 1);
+            minor_ids.reserve(nnz);
+            values.reserve(nnz);
+        }
+
+        /**
+         * appends a row. empty rows are omitted.
+         *
+         * @param id must be greater than the id of every row in this.
+         * @param row an SDR, or any ascending range of elements.
+         */
+        template<typename Row>
+        void push_back(major_id_t id, const Row& row) {
+            assert(major_ids.empty() || major_ids.back() < id);
+            for (const auto& elem : row) push_back_element(elem.id(), elem.data());
+            end_row(id);
+        }
+
+        // the i-th stored row, as a zero-copy read-only SDR
+        row_type row(size_type i) const {
+            size_type begin = major_ptr[i];
+            return row_type(RowView<SDRElem_t>(minor_ids.data() + begin, values.data() + begin, major_ptr[i + 1] - begin));
+        }
+
+        // the row with the id, which is empty if it isn't stored
+        row_type find(major_id_t id) const {
+            auto it = std::lower_bound(major_ids.cbegin(), major_ids.cend(), id);
+            if (it == major_ids.cend() || *it != id) return row_type();
+            return row(static_cast<size_type>(it - major_ids.cbegin()));
+        }
+
+        bool operator==(const CompressedMatrix& o) const {
+            return major_ids == o.major_ids && major_ptr == o.major_ptr && minor_ids == o.minor_ids && values == o.values;
+        }
+
+        bool operator!=(const CompressedMatrix& o) const { return !(*this == o); }
+
+        // multiplies this (a row major matrix) with the arg and returns the result.
+        template<typename ret_t = SDRElem<major_id_t, data_type>, typename c_ret_t = std::vector<ret_t>, typename arg_t, typename c_arg_t>
+        SDR<ret_t, c_ret_t> row_major_mul_vec(const SDR<arg_t, c_arg_t>& arg) const {
+            SDR<ret_t, c_ret_t> ret;
+            nary_ops::Appender<SDR<ret_t, c_ret_t>> append(ret);
+            for (size_type i = 0; i < major_ids.size(); ++i) {
+                auto data = row(i).template inner<typename ret_t::data_type>(arg);
+                if (data.relevant()) append(ret_t(major_ids[i], std::move(data)));
+            }
+            return ret;
+        }
+
+        // multiplies this (a column major matrix) with the arg and returns the result.
+        template<typename ret_t = SDRElem<id_type, data_type>, typename c_ret_t = std::vector<ret_t>, typename arg_t, typename c_arg_t>
+        SDR<ret_t, c_ret_t> col_major_mul_vec(const SDR<arg_t, c_arg_t>& arg) const {
+            std::vector<std::pair<id_type, typename ret_t::data_type>> scratch;
+            size_type i = 0;
+            for (const auto& arg_elem : arg) {
+                i = static_cast<size_type>(std::lower_bound(major_ids.cbegin() + static_cast<std::ptrdiff_t>(i), major_ids.cend(), arg_elem.id()) - major_ids.cbegin());
+                if (i == major_ids.size()) break;
+                if (major_ids[i] != arg_elem.id()) continue;
+                for (size_type pos = major_ptr[i]; pos < major_ptr[i + 1]; ++pos) {
+                    scratch.emplace_back(minor_ids[pos], values[pos].template ande<typename ret_t::data_type>(arg_elem.data()));
+                }
+            }
+            SDR<ret_t, c_ret_t> ret;
+            nary_ops::Appender<SDR<ret_t, c_ret_t>> append(ret);
+            accumulate(scratch, [&](id_type id, typename ret_t::data_type&& data) { append(ret_t(id, std::move(data))); });
+            return ret;
+        }
+
+        /**
+         * The rows become the columns, with a counting sort over the columns (no heap).
+         * If the column ids are integers in a range that's not much larger than the number of elements, then the columns are
+         * found with a dense array over the range, which is O(nnz + range). Otherwise, the distinct columns are sorted and
+         * each element's column is binary searched, which is O(nnz log(nnz)).
+         */
+        CompressedMatrix<SDRElem<major_id_t, data_type>, id_type> transpose() const {
+            CompressedMatrix<SDRElem<major_id_t, data_type>, id_type> ret;
+            // the distinct columns (ascending), and the index of each element's column
+            std::vector<id_type> columns;
+            std::vector<size_type> column_of(minor_ids.size());
+            bool counted = false;
+            if constexpr(std::is_integral_v<id_type>) {
+                if (!minor_ids.empty()) {
+                    auto [lo_it, hi_it] = std::minmax_element(minor_ids.cbegin(), minor_ids.cend());
+                    id_type lo = *lo_it;
+                    std::size_t range = matrix_utils::dense_id_range(lo, *hi_it, minor_ids.size());
+                    if (range != 0) {
+                        // marks the occupied ids, which are then replaced by their column's index
+                        std::vector<size_type> slots(range, 0);
+                        for (id_type id : minor_ids) slots[matrix_utils::id_offset(id, lo)] = 1;
+                        for (std::size_t i = 0; i < range; ++i) {
+                            if (slots[i] == 0) continue;
+                            slots[i] = columns.size();
+                            columns.push_back(matrix_utils::id_at_offset(lo, i));
+                        }
+                        for (size_type pos = 0; pos < minor_ids.size(); ++pos) {
+                            column_of[pos] = slots[matrix_utils::id_offset(minor_ids[pos], lo)];
+                        }
+                        counted = true;
+                    }
+                }
+            }
+            if (!counted) {
+                columns = minor_ids;
+                std::sort(columns.begin(), columns.end());
+                columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+                for (size_type pos = 0; pos < minor_ids.size(); ++pos) {
+                    column_of[pos] = static_cast<size_type>(std::lower_bound(columns.cbegin(), columns.cend(), minor_ids[pos]) - columns.cbegin());
+                }
+            }
+
+            std::vector<size_type> ptr(columns.size() + 1, 0);
+            for (size_type pos = 0; pos < minor_ids.size(); ++pos) ++ptr[column_of[pos] + 1];
+            for (size_type c = 0; c < columns.size(); ++c) ptr[c + 1] += ptr[c];
+
+            ret.major_ids = std::move(columns);
+            ret.major_ptr = ptr;
+            ret.minor_ids.resize(minor_ids.size());
+            ret.values.resize(values.size());
+            // the rows are visited in ascending order, so each column is filled in ascending order
+            for (size_type i = 0; i < major_ids.size(); ++i) {
+                for (size_type pos = major_ptr[i]; pos < major_ptr[i + 1]; ++pos) {
+                    size_type dest = ptr[column_of[pos]]++;
+                    ret.minor_ids[dest] = major_ids[i];
+                    ret.values[dest] = values[pos];
+                }
+            }
+            return ret;
+        }
+
+        /**
+         * Multiply two matrices together.
+         *
+         * Both this and the arg must have the same row/column major format.
+         * Each output row is the combination of the arg's rows which are selected by this row (Gustavson's method).
+         */
+        template<typename arg_t, typename ret_data_t = data_type>
+        CompressedMatrix<SDRElem<typename arg_t::id_type, ret_data_t>, major_id_t> same_mul(const CompressedMatrix<arg_t, id_type>& arg) const {
+            using arg_id_t = typename arg_t::id_type;
+            CompressedMatrix<SDRElem<arg_id_t, ret_data_t>, major_id_t> ret;
+            const auto& arg_majors = arg.get_major_ids();
+            const auto& arg_ptr = arg.get_major_ptr();
+            const auto& arg_minors = arg.get_minor_ids();
+            const auto& arg_values = arg.get_values();
+            std::vector<std::pair<arg_id_t, ret_data_t>> scratch;
+            for (size_type i = 0; i < major_ids.size(); ++i) {
+                scratch.clear();
+                size_type k = 0;
+                for (size_type pos = major_ptr[i]; pos < major_ptr[i + 1]; ++pos) {
+                    // the row's columns are ascending, so the search continues from the last match
+                    k = static_cast<size_type>(std::lower_bound(arg_majors.cbegin() + static_cast<std::ptrdiff_t>(k), arg_majors.cend(), minor_ids[pos]) - arg_majors.cbegin());
+                    if (k == arg_majors.size()) break;
+                    if (arg_majors[k] != minor_ids[pos]) continue;
+                    for (size_type arg_pos = arg_ptr[k]; arg_pos < arg_ptr[k + 1]; ++arg_pos) {
+                        scratch.emplace_back(arg_minors[arg_pos], values[pos].template ande<ret_data_t>(arg_values[arg_pos]));
+                    }
+                }
+                accumulate(scratch, [&](arg_id_t id, ret_data_t&& data) { ret.push_back_element(id, std::move(data)); });
+                ret.end_row(major_ids[i]);
+            }
+            return ret;
+        }
+
+        /**
+         * Multiply two matrices together.
+         *
+         * Both this and the arg must have different row/column major format.
+         * The returned matrix has the same row/column format as this matrix.
+         */
+        template<typename arg_t, typename arg_major_t, typename ret_data_t = data_type>
+        CompressedMatrix<SDRElem<arg_major_t, ret_data_t>, major_id_t> diff_mul(const CompressedMatrix<arg_t, arg_major_t>& arg) const {
+            CompressedMatrix<SDRElem<arg_major_t, ret_data_t>, major_id_t> ret;
+            for (size_type i = 0; i < major_ids.size(); ++i) {
+                row_type r = row(i);
+                for (size_type j = 0; j < arg.majors(); ++j) {
+                    auto data = r.template inner<ret_data_t>(arg.row(j));
+                    if (data.relevant()) ret.push_back_element(arg.get_major_ids()[j], std::move(data));
+                }
+                ret.end_row(major_ids[i]);
+            }
+            return ret;
+        }
+
+    private:
+        template<typename friend_SDRElem_t, typename friend_major_id_t>
+        friend class CompressedMatrix;
+
+        template<typename D>
+        void push_back_element(id_type id, D&& data) {
+            assert(major_ptr.back() == minor_ids.size() || minor_ids.back() < id);
+            minor_ids.push_back(id);
+            values.push_back(std::forward<D>(data));
+        }
+
+        // ends the row of elements pushed since the last row, unless it's empty
+        void end_row(major_id_t id) {
+            if (major_ptr.back() == minor_ids.size()) return;
+            major_ids.push_back(id);
+            major_ptr.push_back(minor_ids.size());
+        }
+
+        // sorts the (id, data) pairs by id and combines the same id elements (via ori), in the order they were added.
+        // the relevant combined elements are given to the output, in ascending order
+        template<typename id_t, typename data_t, typename Output>
+        static void accumulate(std::vector<std::pair<id_t, data_t>>& scratch, Output output) {
+            std::stable_sort(scratch.begin(), scratch.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+            auto it = scratch.begin();
+            while (it != scratch.end()) {
+                auto group = it++;
+                while (it != scratch.end() && it->first == group->first) {
+                    group->second.ori(it->second);
+                    ++it;
+                }
+                if (group->second.relevant()) output(group->first, std::move(group->second));
+            }
+        }
+
+        std::vector<major_id_t> major_ids;
+        std::vector<size_type> major_ptr;
+        std::vector<id_type> minor_ids;
+        std::vector<data_type> values;
+};
+
+} // namespace sparse_distributed_representation
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+#include "SparseDistributedRepresentation/SDR.hpp"
+#include "SparseDistributedRepresentation/MinHash.hpp"
+
+namespace sparse_distributed_representation {
+
+namespace fingerprint {
+
+// each id contributes a hash, and the fingerprint is their sum.
+// the sum doesn't depend on the order, so a single id can be added or removed in O(1)
+template<typename id_t>
+std::uint64_t of_id(const id_t& id) {
+    return minhash::mix(static_cast<std::uint64_t>(id));
+}
+
+// the fingerprint of an SDR, in a single pass over its ids. only the ids are used, not the data
+template<typename SDRElem_t, typename container_t>
+std::uint64_t of(const SDR<SDRElem_t, container_t>& sdr) {
+    std::uint64_t ret = 0;
+    for (const auto& elem : sdr) ret += of_id(elem.id());
+    return ret;
+}
+
+} // namespace fingerprint
+
+/**
+ * An SDR with a cached 64-bit fingerprint of its ids.
+ *
+ * SDRs with different fingerprints are never equal, so comparisons between FingerprintedSDRs check the fingerprint
+ * before walking the elements, and std::hash is the fingerprint (O(1)).
+ *
+ * The SDR can only be modified through this, so the fingerprint is always in sync.
+ * push_back, insert, and erase update it incrementally. Bulk ops (andi, ori, xori, rmi, shift, or modify) recompute it.
+ */
+template<typename SDRElem_t = SDRElem<>, typename container_t = std::vector<SDRElem_t>>
+class FingerprintedSDR {
+    public:
+        using sdr_type = SDR<SDRElem_t, container_t>;
+        using value_type = typename sdr_type::value_type;
+        using size_type = typename sdr_type::size_type;
+        using const_iterator = typename sdr_type::const_iterator;
+
+        FingerprintedSDR() : fp(0) {}
+
+        FingerprintedSDR(sdr_type sdr) : s(std::move(sdr)), fp(fingerprint::of(s)) {}
+
+        template<typename T>
+        FingerprintedSDR(std::initializer_list<T> list) : FingerprintedSDR(sdr_type(list)) {}
+
+        const sdr_type& sdr() const { return s; }
+        std::uint64_t fingerprint() const { return fp; }
+
+        auto cbegin() const { return s.cbegin(); }
+        auto cend() const { return s.cend(); }
+        auto begin() const { return s.cbegin(); }
+        auto end() const { return s.cend(); }
+        auto empty() const { return s.empty(); }
+        auto size() const { return s.size(); }
+
+        // moves the SDR out, leaving this empty
+        sdr_type release() {
+            fp = 0;
+            return std::move(s);
+        }
+
+        void clear() noexcept {
+            s.clear();
+            fp = 0;
+        }
+
+        // only a new id is added to the fingerprint. a set-like container doesn't grow when it already has the id
+        template<typename E>
+        void push_back(E&& i) {
+            auto old_size = s.size();
+            s.push_back(std::forward<E>(i));
+            if (s.size() != old_size) fp += fingerprint::of_id(std::prev(s.cend())->id());
+        }
+
+        template<typename E>
+        const_iterator insert(const_iterator position, E&& i) {
+            auto old_size = s.size();
+            const_iterator ret = s.insert(position, std::forward<E>(i));
+            if (s.size() != old_size) fp += fingerprint::of_id(ret->id());
+            return ret;
+        }
+
+        const_iterator erase(const_iterator position) {
+            fp -= fingerprint::of_id(position->id());
+            return s.erase(position);
+        }
+
+        const_iterator erase(const_iterator first, const_iterator last) {
+            for (auto it = first; it != last; ++it) fp -= fingerprint::of_id(it->id());
+            return s.erase(first, last);
+        }
+
+        // applies fn to the SDR, then recomputes the fingerprint
+        template<typename Fn>
+        FingerprintedSDR& modify(Fn&& fn) {
+            fn(s);
+            fp = fingerprint::of(s);
+            return *this;
+        }
+
+        template<typename arg_t>
+        FingerprintedSDR& andi(arg_t&& arg) { return modify([&](sdr_type& me) { me.andi(unwrap(std::forward<arg_t>(arg))); }); }
+        template<typename arg_t>
+        FingerprintedSDR& ori(arg_t&& arg) { return modify([&](sdr_type& me) { me.ori(unwrap(std::forward<arg_t>(arg))); }); }
+        template<typename arg_t>
+        FingerprintedSDR& xori(arg_t&& arg) { return modify([&](sdr_type& me) { me.xori(unwrap(std::forward<arg_t>(arg))); }); }
+        template<typename arg_t>
+        FingerprintedSDR& rmi(arg_t&& arg) { return modify([&](sdr_type& me) { me.rmi(unwrap(std::forward<arg_t>(arg))); }); }
+        FingerprintedSDR& shift(int amount) { return modify([&](sdr_type& me) { me.shift(amount); }); }
+
+        template<typename arg_t, typename c_arg_t>
+        bool operator==(const FingerprintedSDR<arg_t, c_arg_t>& other) const {
+            return fp == other.fingerprint() && s == other.sdr();
+        }
+
+        template<typename arg_t, typename c_arg_t>
+        bool operator!=(const FingerprintedSDR<arg_t, c_arg_t>& other) const { return !(*this == other); }
+
+        template<typename arg_t, typename c_arg_t>
+        bool operator==(const SDR<arg_t, c_arg_t>& other) const { return s == other; }
+
+        template<typename arg_t, typename c_arg_t>
+        bool operator!=(const SDR<arg_t, c_arg_t>& other) const { return !(*this == other); }
+
+        friend std::ostream& operator<<(std::ostream& os, const FingerprintedSDR& sdr) { return os << sdr.s; }
+
+    private:
+        template<typename T>
+        static T&& unwrap(T&& arg) { return std::forward<T>(arg); }
+
+        template<typename arg_t, typename c_arg_t>
+        static const SDR<arg_t, c_arg_t>& unwrap(const FingerprintedSDR<arg_t, c_arg_t>& arg) { return arg.sdr(); }
+
+        template<typename arg_t, typename c_arg_t>
+        static const SDR<arg_t, c_arg_t>& unwrap(FingerprintedSDR<arg_t, c_arg_t>& arg) { return arg.sdr(); }
+
+        template<typename arg_t, typename c_arg_t>
+        static SDR<arg_t, c_arg_t> unwrap(FingerprintedSDR<arg_t, c_arg_t>&& arg) { return arg.release(); }
+
+        sdr_type s;
+        std::uint64_t fp;
+};
+
+} // namespace sparse_distributed_representation
+
+namespace std {
+
+// O(n). equal SDRs have equal ids, so they hash the same
+template<typename SDRElem_t, typename container_t>
+struct hash<sparse_distributed_representation::SDR<SDRElem_t, container_t>> {
+    std::size_t operator()(const sparse_distributed_representation::SDR<SDRElem_t, container_t>& sdr) const {
+        return static_cast<std::size_t>(sparse_distributed_representation::fingerprint::of(sdr));
+    }
+};
+
+// O(1), from the cached fingerprint
+template<typename SDRElem_t, typename container_t>
+struct hash<sparse_distributed_representation::FingerprintedSDR<SDRElem_t, container_t>> {
+    std::size_t operator()(const sparse_distributed_representation::FingerprintedSDR<SDRElem_t, container_t>& sdr) const {
+        return static_cast<std::size_t>(sdr.fingerprint());
+    }
+};
+
+} // namespace std
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "SparseDistributedRepresentation/SDR.hpp"
+#include "SparseDistributedRepresentation/SDRRange.hpp"
+
+namespace sparse_distributed_representation {
+
+namespace hamming_search {
+
+struct Match {
+    std::size_t index; // the position of the candidate in the range
+    std::size_t distance;
+
+    bool operator==(const Match& o) const { return index == o.index && distance == o.distance; }
+};
+
+} // namespace hamming_search
+
+/**
+ * Finds the k candidates with the smallest hamming distance (xors) to the query.
+ * Like the n-ary ops, the candidates are a range of SDRs, or pointers to SDRs, or std::reference_wrappers of SDRs.
+ *
+ * Once k candidates have been seen, the k-th best distance bounds the rest of the candidates,
+ * so each comparison uses xors_bounded and stops as soon as the candidate can't be one of the k best.
+ * The bound only shrinks, so the better the early candidates are, the sooner the later ones stop.
+ *
+ * @return up to k matches, by ascending distance (ties by ascending index).
+ */
+template<typename SDRElem_t, typename container_t, typename Range>
+std::vector<hamming_search::Match> hamming_k_nearest(const SDR<SDRElem_t, container_t>& query, const Range& candidates, std::size_t k) {
+    using hamming_search::Match;
+    std::vector<Match> best; // a max heap by distance, so the k-th best is at the front
+    if (k == 0) return best;
+    best.reserve(k);
+    auto worse = [](const Match& a, const Match& b) { return a.distance < b.distance || (a.distance == b.distance && a.index < b.index); };
+    std::size_t index = 0;
+    for (const auto& candidate : candidates) {
+        if (best.size() < k) {
+            best.push_back(Match{index, query.xors(nary_ops::deref(candidate))});
+            std::push_heap(best.begin(), best.end(), worse);
+        } else {
+            // ties keep the earlier candidate, so only a strictly smaller distance replaces the k-th best
+            if (best.front().distance == 0) break;
+            std::size_t limit = best.front().distance - 1;
+            std::size_t distance = query.xors_bounded(nary_ops::deref(candidate), limit);
+            if (distance <= limit) {
+                std::pop_heap(best.begin(), best.end(), worse);
+                best.back() = Match{index, distance};
+                std::push_heap(best.begin(), best.end(), worse);
+            }
+        }
+        ++index;
+    }
+    std::sort_heap(best.begin(), best.end(), worse);
+    return best;
+}
+
+} // namespace sparse_distributed_representation
@@ -1,6 +1,10 @@
+#pragma once
+
 #include <vector>
 #include <iterator>
 
+#include "SparseDistributedRepresentation/IntersectKernels.hpp"
+
 namespace sparse_distributed_representation {
 
 namespace id_contiguous_container_objs {
@@ -301,8 +305,24 @@ class IDContiguousContainer {
             ids.shrink_to_fit();
             datas.shrink_to_fit();
         }
+
+        const ids_t& get_ids() const { return ids; }
 };
 
+namespace intersect_kernels {
+
+// the id segment can be given directly to the intersection kernels
+template<typename SDRElem_t, typename id_t, typename A, typename datas_t>
+struct contiguous_ids<IDContiguousContainer<SDRElem_t, std::vector<id_t, A>, datas_t>> : std::true_type {
+    using id_type = id_t;
+
+    static const id_t* ids(const IDContiguousContainer<SDRElem_t, std::vector<id_t, A>, datas_t>& c) {
+        return c.get_ids().data();
+    }
+};
+
+} // namespace intersect_kernels
+
 } // namespace
 
 namespace std {
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <algorithm>
+#include <assert.h>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+#include "SparseDistributedRepresentation/IntersectKernels.hpp"
+
+namespace sparse_distributed_representation {
+
+// a vector which stores up to inline_capacity elements within itself, and only allocates if it grows past that.
+// most SDRs used per timestep are small (e.g. 40 elements), so ops which produce an SDR like this don't allocate.
+//
+// it has random access iterators, so it is vector_like (SDR uses the same code paths as for std::vector).
+// the element type can be any SDRElem_t.
+//
+// Only the necessary functions have been implemented (for use in SDR).
+template<typename SDRElem_t, std::size_t inline_capacity>
+class InlineContainer {
+    static_assert(inline_capacity > 0, "InlineContainer needs an inline capacity");
+
+    public:
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using value_type = SDRElem_t;
+        using reference = SDRElem_t&;
+        using const_reference = const SDRElem_t&;
+        using pointer = SDRElem_t*;
+        using const_pointer = const SDRElem_t*;
+        using iterator = SDRElem_t*;
+        using const_iterator = const SDRElem_t*;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        InlineContainer() : ptr(inline_ptr()), count(0), cap(inline_capacity) {}
+
+        InlineContainer(const InlineContainer& o) : InlineContainer() {
+            reserve(o.count);
+            std::uninitialized_copy(o.begin(), o.end(), ptr);
+            count = o.count;
+        }
+
+        InlineContainer(InlineContainer&& o) noexcept : InlineContainer() {
+            take(std::move(o));
+        }
+
+        InlineContainer& operator=(const InlineContainer& o) {
+            if (this != &o) {
+                clear();
+                reserve(o.count);
+                std::uninitialized_copy(o.begin(), o.end(), ptr);
+                count = o.count;
+            }
+            return *this;
+        }
+
+        InlineContainer& operator=(InlineContainer&& o) noexcept {
+            if (this != &o) {
+                clear();
+                deallocate();
+                take(std::move(o));
+            }
+            return *this;
+        }
+
+        ~InlineContainer() {
+            clear();
+            deallocate();
+        }
+
+        size_type size() const { return count; }
+        bool empty() const { return count == 0; }
+        size_type capacity() const { return cap; }
+
+        // if the elements are stored within this (instead of in an allocation)
+        bool is_inline() const { return ptr == inline_ptr(); }
+
+        iterator begin() { return ptr; }
+        iterator end() { return ptr + count; }
+        const_iterator begin() const { return ptr; }
+        const_iterator end() const { return ptr + count; }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+        reverse_iterator rbegin() { return reverse_iterator(end()); }
+        reverse_iterator rend() { return reverse_iterator(begin()); }
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+        const_reverse_iterator crbegin() const { return rbegin(); }
+        const_reverse_iterator crend() const { return rend(); }
+
+        SDRElem_t* data() { return ptr; }
+        const SDRElem_t* data() const { return ptr; }
+
+        reference operator[](size_type pos) { return ptr[pos]; }
+        const_reference operator[](size_type pos) const { return ptr[pos]; }
+        reference front() { return ptr[0]; }
+        const_reference front() const { return ptr[0]; }
+        reference back() { return ptr[count - 1]; }
+        const_reference back() const { return ptr[count - 1]; }
+
+        void reserve(size_type n) {
+            if (n > cap) reallocate(n);
+        }
+
+        // moves the elements back within this if they fit, else shrinks the allocation
+        void shrink_to_fit() {
+            if (!is_inline() && count < cap) reallocate(count);
+        }
+
+        void clear() noexcept {
+            std::destroy(begin(), end());
+            count = 0;
+        }
+
+        void resize(size_type n) {
+            if (n < count) {
+                std::destroy(begin() + n, end());
+            } else {
+                reserve(n);
+                std::uninitialized_value_construct(end(), begin() + n);
+            }
+            count = n;
+        }
+
+        template<typename... Args>
+        reference emplace_back(Args&&... args) {
+            if (count == cap) reallocate(grown(count + 1));
+            SDRElem_t* elem = new (ptr + count) SDRElem_t(std::forward<Args>(args)...);
+            ++count;
+            return *elem;
+        }
+
+        void push_back(const SDRElem_t& elem) { emplace_back(elem); }
+        void push_back(SDRElem_t&& elem) { emplace_back(std::move(elem)); }
+
+        iterator insert(const_iterator position, SDRElem_t elem) {
+            size_type index = static_cast<size_type>(position - begin());
+            if (index == count) {
+                emplace_back(std::move(elem));
+                return begin() + index;
+            }
+            if (count == cap) reallocate(grown(count + 1));
+            // shift the elements after the position up by one
+            new (ptr + count) SDRElem_t(std::move(ptr[count - 1]));
+            std::move_backward(begin() + index, end() - 1, end());
+            ++count;
+            ptr[index] = std::move(elem);
+            return begin() + index;
+        }
+
+        iterator erase(const_iterator position) {
+            return erase(position, position + 1);
+        }
+
+        iterator erase(const_iterator first, const_iterator last) {
+            iterator f = begin() + (first - begin());
+            iterator l = begin() + (last - begin());
+            if (f != l) {
+                iterator new_end = std::move(l, end(), f);
+                std::destroy(new_end, end());
+                count -= static_cast<size_type>(l - f);
+            }
+            return f;
+        }
+
+    private:
+        SDRElem_t* inline_ptr() { return reinterpret_cast<SDRElem_t*>(&buffer); } // NOLINT
+        const SDRElem_t* inline_ptr() const { return reinterpret_cast<const SDRElem_t*>(&buffer); } // NOLINT
+
+        size_type grown(size_type needed) const { return std::max(needed, cap * 2); }
+
+        // moves the elements into storage with capacity n (within this if n fits)
+        void reallocate(size_type n) {
+            assert(n >= count);
+            SDRElem_t* dest = n <= inline_capacity ? inline_ptr() : std::allocator<SDRElem_t>().allocate(n);
+            if (dest == ptr) return;
+            std::uninitialized_move(begin(), end(), dest);
+            std::destroy(begin(), end());
+            deallocate();
+            ptr = dest;
+            cap = n <= inline_capacity ? inline_capacity : n;
+        }
+
+        void deallocate() {
+            if (!is_inline()) std::allocator<SDRElem_t>().deallocate(ptr, cap);
+            ptr = inline_ptr();
+            cap = inline_capacity;
+        }
+
+        // this must be empty and inline
+        void take(InlineContainer&& o) {
+            if (o.is_inline()) {
+                std::uninitialized_move(o.begin(), o.end(), ptr);
+                count = o.count;
+                o.clear();
+            } else {
+                // steal the allocation
+                ptr = o.ptr;
+                count = o.count;
+                cap = o.cap;
+                o.ptr = o.inline_ptr();
+                o.count = 0;
+                o.cap = inline_capacity;
+            }
+        }
+
+        std::aligned_storage_t<sizeof(SDRElem_t) * inline_capacity, alignof(SDRElem_t)> buffer;
+        SDRElem_t* ptr;
+        size_type count;
+        size_type cap;
+};
+
+namespace intersect_kernels {
+
+// same as std::vector
+template<typename id_t, std::size_t inline_capacity>
+struct contiguous_ids<InlineContainer<SDRElem<id_t, EmptyData>, inline_capacity>>
+    : std::bool_constant<sizeof(SDRElem<id_t, EmptyData>) == sizeof(id_t) && std::is_standard_layout_v<SDRElem<id_t, EmptyData>>> {
+    using id_type = id_t;
+
+    static const id_t* ids(const InlineContainer<SDRElem<id_t, EmptyData>, inline_capacity>& v) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        return reinterpret_cast<const id_t*>(v.data());
+    }
+};
+
+} // namespace intersect_kernels
+
+} // namespace sparse_distributed_representation
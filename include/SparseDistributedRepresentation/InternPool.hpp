@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <unordered_set>
+
+#include "SparseDistributedRepresentation/Fingerprint.hpp"
+
+namespace sparse_distributed_representation {
+
+template<typename SDRElem_t, typename container_t>
+class InternPool;
+
+/**
+ * A handle to an SDR in an InternPool.
+ * Handles from the same pool are equal if and only if their SDRs are equal, so equality is a pointer compare.
+ * A default constructed handle doesn't refer to any SDR.
+ */
+template<typename SDRElem_t = SDRElem<>, typename container_t = std::vector<SDRElem_t>>
+class InternHandle {
+    public:
+        using sdr_type = SDR<SDRElem_t, container_t>;
+
+        InternHandle() : p(nullptr) {}
+
+        const sdr_type& operator*() const { return p->sdr(); }
+        const sdr_type* operator->() const { return &p->sdr(); }
+        const sdr_type& get() const { return p->sdr(); }
+        std::uint64_t fingerprint() const { return p->fingerprint(); }
+
+        explicit operator bool() const { return p != nullptr; }
+
+        bool operator==(const InternHandle& o) const { return p == o.p; }
+        bool operator!=(const InternHandle& o) const { return p != o.p; }
+
+    private:
+        friend class InternPool<SDRElem_t, container_t>;
+        friend struct std::hash<InternHandle>;
+
+        explicit InternHandle(const FingerprintedSDR<SDRElem_t, container_t>* p) : p(p) {}
+
+        const FingerprintedSDR<SDRElem_t, container_t>* p;
+};
+
+/**
+ * Stores each distinct SDR once (hash-consing).
+ * Interning an SDR gives a handle to the pool's immutable copy, so repeated SDRs share the same storage,
+ * and handles can key a map (e.g. to memoize ops) with an O(1) hash and compare.
+ *
+ * Interning looks up the SDR by its fingerprint, and only compares the elements of SDRs with the same fingerprint.
+ * The pooled SDRs are never moved, so handles stay valid until the pool is cleared or destroyed.
+ */
+template<typename SDRElem_t = SDRElem<>, typename container_t = std::vector<SDRElem_t>>
+class InternPool {
+    public:
+        using sdr_type = SDR<SDRElem_t, container_t>;
+        using handle = InternHandle<SDRElem_t, container_t>;
+        using size_type = std::size_t;
+
+        // the number of distinct SDRs
+        size_type size() const { return pool.size(); }
+        bool empty() const { return pool.empty(); }
+
+        // the handle to the pooled copy of the SDR, which is added to the pool if it isn't already there
+        handle intern(sdr_type sdr) {
+            return intern(FingerprintedSDR<SDRElem_t, container_t>(std::move(sdr)));
+        }
+
+        handle intern(FingerprintedSDR<SDRElem_t, container_t> sdr) {
+            return handle(&*pool.insert(std::move(sdr)).first);
+        }
+
+        // the handle to the pooled copy of the SDR, or a null handle if it isn't in the pool
+        handle find(const sdr_type& sdr) const {
+            auto it = pool.find(FingerprintedSDR<SDRElem_t, container_t>(sdr));
+            return it == pool.end() ? handle() : handle(&*it);
+        }
+
+        // invalidates every handle
+        void clear() { pool.clear(); }
+
+    private:
+        // the elements of an unordered_set are never moved, even on a rehash
+        std::unordered_set<FingerprintedSDR<SDRElem_t, container_t>> pool;
+};
+
+} // namespace sparse_distributed_representation
+
+namespace std {
+
+template<typename SDRElem_t, typename container_t>
+struct hash<sparse_distributed_representation::InternHandle<SDRElem_t, container_t>> {
+    std::size_t operator()(const sparse_distributed_representation::InternHandle<SDRElem_t, container_t>& h) const {
+        return h.p ? static_cast<std::size_t>(h.p->fingerprint()) : 0;
+    }
+};
+
+} // namespace std
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "SparseDistributedRepresentation/SDRElem.hpp"
+
+namespace sparse_distributed_representation {
+
+namespace intersect_kernels {
+
+/**
+ * Whether the ids in a container are stored contiguously, such that they can be read as a plain array.
+ * e.g. a std::vector<SDRElem<int, EmptyData>> is really just a vector of ints.
+ *
+ * Specializations provide: static const id_type* ids(const container_t&)
+ */
+template<typename container_t, typename = void>
+struct contiguous_ids : std::false_type {};
+
+template<typename id_t, typename A>
+struct contiguous_ids<std::vector<SDRElem<id_t, EmptyData>, A>>
+    : std::bool_constant<sizeof(SDRElem<id_t, EmptyData>) == sizeof(id_t) && std::is_standard_layout_v<SDRElem<id_t, EmptyData>>> {
+    using id_type = id_t;
+
+    static const id_t* ids(const std::vector<SDRElem<id_t, EmptyData>, A>& v) {
+        // the id is the first (and only non-empty) member of the element
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        return reinterpret_cast<const id_t*>(v.data());
+    }
+};
+
+// the kernels can be used if both containers have contiguous ids of the same integral type
+template<typename c_a_t, typename c_b_t, typename = void>
+struct applies : std::false_type {};
+
+template<typename c_a_t, typename c_b_t>
+struct applies<c_a_t, c_b_t, std::enable_if_t<contiguous_ids<c_a_t>::value && contiguous_ids<c_b_t>::value>>
+    : std::bool_constant<std::is_same_v<typename contiguous_ids<c_a_t>::id_type, typename contiguous_ids<c_b_t>::id_type>
+                      && std::is_integral_v<typename contiguous_ids<c_a_t>::id_type>
+                      && (sizeof(typename contiguous_ids<c_a_t>::id_type) == 4 || sizeof(typename contiguous_ids<c_a_t>::id_type) == 8)> {};
+
+namespace {
+
+// block_mask(a, b) compares a block of ids from a with a block of ids from b (every element with every element).
+// the returned mask has bit k set if a[k] is somewhere in b's block
+
+#if defined(__AVX2__)
+
+constexpr std::size_t block_32 = 8;
+inline unsigned block_mask(const std::int32_t* a, const std::int32_t* b) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+    // lane k takes from lane k + 1
+    const __m256i rotate = _mm256_set_epi32(0, 7, 6, 5, 4, 3, 2, 1);
+    __m256i m = _mm256_cmpeq_epi32(va, vb);
+    for (int r = 1; r < 8; ++r) {
+        vb = _mm256_permutevar8x32_epi32(vb, rotate);
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi32(va, vb));
+    }
+    return _mm256_movemask_ps(_mm256_castsi256_ps(m));
+}
+
+constexpr std::size_t block_64 = 4;
+inline unsigned block_mask(const std::int64_t* a, const std::int64_t* b) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+    __m256i m = _mm256_cmpeq_epi64(va, vb);
+    for (int r = 1; r < 4; ++r) {
+        vb = _mm256_permute4x64_epi64(vb, _MM_SHUFFLE(0, 3, 2, 1));
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi64(va, vb));
+    }
+    return _mm256_movemask_pd(_mm256_castsi256_pd(m));
+}
+
+#elif defined(__SSE2__)
+
+constexpr std::size_t block_32 = 4;
+inline unsigned block_mask(const std::int32_t* a, const std::int32_t* b) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+    __m128i m = _mm_cmpeq_epi32(va, vb);
+    for (int r = 1; r < 4; ++r) {
+        vb = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+        m = _mm_or_si128(m, _mm_cmpeq_epi32(va, vb));
+    }
+    return _mm_movemask_ps(_mm_castsi128_ps(m));
+}
+
+#if defined(__SSE4_1__)
+constexpr std::size_t block_64 = 2;
+inline unsigned block_mask(const std::int64_t* a, const std::int64_t* b) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+    __m128i m = _mm_or_si128(_mm_cmpeq_epi64(va, vb), _mm_cmpeq_epi64(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+    return _mm_movemask_pd(_mm_castsi128_pd(m));
+}
+#else
+constexpr std::size_t block_64 = 0;
+#endif
+
+#else
+
+// scalar fallback only
+constexpr std::size_t block_32 = 0;
+constexpr std::size_t block_64 = 0;
+
+#endif
+
+// signed and unsigned ids are compared for equality only, so they share a kernel
+template<typename id_t>
+using kernel_id = std::conditional_t<sizeof(id_t) == 4, std::int32_t, std::int64_t>;
+
+template<typename id_t>
+constexpr std::size_t block_size() {
+    return sizeof(id_t) == 4 ? block_32 : block_64;
+}
+
+template<bool count_only, typename id_t, typename Visitor>
+std::size_t intersect_impl(const id_t* a, std::size_t a_len, const id_t* b, std::size_t b_len, Visitor& visitor) {
+    std::size_t count = 0;
+    std::size_t i = 0;
+    std::size_t j = 0;
+    if constexpr(block_size<id_t>() != 0) {
+        constexpr std::size_t block = block_size<id_t>();
+        while (i + block <= a_len && j + block <= b_len) {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            unsigned mask = block_mask(reinterpret_cast<const kernel_id<id_t>*>(a + i), reinterpret_cast<const kernel_id<id_t>*>(b + j));
+            // read before calling the visitor, in case it writes to elements in this block
+            id_t a_max = a[i + block - 1];
+            id_t b_max = b[j + block - 1];
+            if constexpr(count_only) {
+                count += __builtin_popcount(mask);
+            } else {
+                while (mask) {
+                    std::size_t k = __builtin_ctz(mask);
+                    mask &= mask - 1;
+                    std::size_t l = 0;
+                    while (b[j + l] != a[i + k]) ++l;
+                    visitor(i + k, j + l);
+                }
+            }
+            if (a_max <= b_max) i += block;
+            if (b_max <= a_max) j += block;
+        }
+    }
+    // scalar merge for whatever didn't fit into a block
+    while (i < a_len && j < b_len) {
+        if (a[i] < b[j]) {
+            ++i;
+        } else if (a[i] > b[j]) {
+            ++j;
+        } else {
+            if constexpr(count_only) {
+                ++count;
+            } else {
+                visitor(i, j);
+            }
+            ++i;
+            ++j;
+        }
+    }
+    return count;
+}
+
+} // namespace
+
+/**
+ * Intersect two ascending arrays of ids.
+ * visitor(a_index, b_index) is called for each shared id, in ascending order.
+ * The visitor may write to elements before a_index or b_index.
+ */
+template<typename id_t, typename Visitor>
+void intersect(const id_t* a, std::size_t a_len, const id_t* b, std::size_t b_len, Visitor visitor) {
+    intersect_impl<false>(a, a_len, b, b_len, visitor);
+}
+
+/**
+ * @return the number of ids shared between two ascending arrays of ids.
+ */
+template<typename id_t>
+std::size_t intersect_count(const id_t* a, std::size_t a_len, const id_t* b, std::size_t b_len) {
+    auto unused = [](std::size_t, std::size_t) {};
+    return intersect_impl<true>(a, a_len, b, b_len, unused);
+}
+
+} // namespace intersect_kernels
+
+} // namespace sparse_distributed_representation
@@ -0,0 +1,267 @@
+#pragma once
+
+#include <algorithm>
+#include <assert.h>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "SparseDistributedRepresentation/SDR.hpp"
+
+namespace sparse_distributed_representation {
+
+/**
+ * An index over a collection of stored SDRs, which finds the stored SDRs that overlap the most with a query SDR.
+ * Each stored SDR is identified by a key.
+ *
+ * For each id, a posting list has every stored SDR which contains the id.
+ * A query counts the overlap of each stored SDR by walking the posting lists of the query's ids.
+ * Stored SDRs can be inserted and erased at any time. Each stored SDR knows its position in each of its posting lists,
+ * so erasing only visits the SDR's own ids, regardless of how long the posting lists are.
+ *
+ * Queries use scratch space in the index, so queries on the same index must not run concurrently.
+ *
+ * @tparam id_t the id type of the stored SDRs' elements.
+ * @tparam key_t identifies each stored SDR.
+ */
+template<typename id_t = int, typename key_t = std::size_t>
+class InvertedIndex {
+    public:
+        using id_type = id_t;
+        using key_type = key_t;
+        using size_type = std::size_t;
+
+        struct Match {
+            key_t key;
+            size_type overlap;
+
+            bool operator==(const Match& o) const { return key == o.key && overlap == o.overlap; }
+        };
+
+        // the number of stored SDRs
+        size_type size() const { return keys.size(); }
+        bool empty() const { return keys.empty(); }
+
+        bool contains(const key_t& key) const { return keys.find(key) != keys.end(); }
+
+        /**
+         * stores an SDR's ids. if the key is already stored, then it is replaced.
+         *
+         * @param begin iterator to the first element (which has an id()) of the SDR.
+         * @param end iterator to one past the last element.
+         */
+        template<typename Iterator>
+        void insert(const key_t& key, Iterator begin, Iterator end) {
+            erase(key);
+            slot_t slot;
+            if (free_slots.empty()) {
+                slot = static_cast<slot_t>(slots.size());
+                slots.emplace_back();
+                counters.push_back(0);
+            } else {
+                slot = free_slots.back();
+                free_slots.pop_back();
+            }
+            Slot& s = slots[slot];
+            s.key = key;
+            for (auto it = begin; it != end; ++it) {
+                id_t id = it->id();
+                auto& list = postings[id];
+                s.ids.push_back(id);
+                s.positions.push_back(static_cast<position_t>(list.size()));
+                list.push_back(slot);
+            }
+            keys.emplace(key, slot);
+        }
+
+        template<typename SDRElem_t, typename container_t>
+        void insert(const key_t& key, const SDR<SDRElem_t, container_t>& sdr) {
+            insert(key, sdr.cbegin(), sdr.cend());
+        }
+
+        // removes a stored SDR. returns false if the key isn't stored
+        bool erase(const key_t& key) {
+            auto it = keys.find(key);
+            if (it == keys.end()) return false;
+            slot_t slot = it->second;
+            keys.erase(it);
+            Slot& s = slots[slot];
+            for (size_type i = 0; i < s.ids.size(); ++i) {
+                id_t id = s.ids[i];
+                auto posting = postings.find(id);
+                assert(posting != postings.end());
+                auto& list = posting->second;
+                position_t pos = s.positions[i];
+                assert(list[pos] == slot);
+                // the order within a posting list doesn't matter. the last entry fills the gap, and its position is updated
+                slot_t moved = list.back();
+                list[pos] = moved;
+                list.pop_back();
+                if (moved != slot) {
+                    Slot& m = slots[moved];
+                    auto m_id = std::lower_bound(m.ids.cbegin(), m.ids.cend(), id);
+                    assert(m_id != m.ids.cend() && *m_id == id);
+                    m.positions[static_cast<size_type>(m_id - m.ids.cbegin())] = pos;
+                }
+                if (list.empty()) postings.erase(posting);
+            }
+            s.ids.clear();
+            s.ids.shrink_to_fit();
+            s.positions.clear();
+            s.positions.shrink_to_fit();
+            free_slots.push_back(slot);
+            return true;
+        }
+
+        void clear() {
+            postings.clear();
+            slots.clear();
+            free_slots.clear();
+            keys.clear();
+            counters.clear();
+        }
+
+        // the overlap between a query and a stored SDR (same as ands)
+        template<typename SDRElem_t, typename container_t>
+        size_type overlap(const SDR<SDRElem_t, container_t>& query, const key_t& key) const {
+            auto it = keys.find(key);
+            if (it == keys.end()) return 0;
+            const auto& ids = slots[it->second].ids;
+            size_type r = 0;
+            for (const auto& elem : query) {
+                if (std::binary_search(ids.begin(), ids.end(), static_cast<id_t>(elem.id()))) ++r;
+            }
+            return r;
+        }
+
+        /**
+         * finds the stored SDRs with the largest overlap with the query.
+         *
+         * the posting lists are walked from shortest to longest.
+         * once the remaining lists can't give an unseen SDR more overlap than the kth best so far, unseen SDRs are ignored.
+         * after that, if a posting list is much longer than the number of remaining candidates,
+         * the candidates are searched for the id instead of walking the list.
+         *
+         * @param k the maximum number of results.
+         * @param min_overlap results must have at least this much overlap.
+         * @return the matches, by descending overlap (ties by ascending key).
+         */
+        template<typename SDRElem_t, typename container_t>
+        std::vector<Match> top_k(const SDR<SDRElem_t, container_t>& query, size_type k, size_type min_overlap = 1) const {
+            std::vector<Match> ret;
+            if (k == 0) return ret;
+            if (min_overlap == 0) min_overlap = 1;
+
+            std::vector<std::pair<id_t, const std::vector<slot_t>*>> lists;
+            for (const auto& elem : query) {
+                auto it = postings.find(static_cast<id_t>(elem.id()));
+                if (it != postings.end()) lists.emplace_back(it->first, &it->second);
+            }
+            std::sort(lists.begin(), lists.end(), [](const auto& a, const auto& b) { return a.second->size() < b.second->size(); });
+
+            // histogram[c] is the number of candidates with a count of c
+            std::vector<size_type> histogram(lists.size() + 1);
+            // kth is the kth largest count so far (0 if there are less than k candidates). counts only increase, so it's a lower bound
+            size_type kth = 0;
+            size_type above_kth = 0; // number of candidates with a count greater than kth
+            touched.clear();
+
+            auto increment = [&](slot_t slot) {
+                count_t c = counters[slot]++;
+                --histogram[c];
+                ++histogram[c + 1];
+                if (c == kth) {
+                    ++above_kth;
+                    while (above_kth >= k) {
+                        ++kth;
+                        above_kth -= histogram[kth];
+                    }
+                }
+            };
+
+            bool admitting = true;
+            for (size_type i = 0; i < lists.size(); ++i) {
+                size_type remaining = lists.size() - i;
+                const std::vector<slot_t>& list = *lists[i].second;
+                // an unseen SDR can get at most a count of remaining. if that's less than the kth best so far, it can't be in the result
+                if (admitting && (remaining < min_overlap || (touched.size() >= k && remaining < kth))) {
+                    admitting = false;
+                    // drop the candidates which can't reach the kth best or the min overlap
+                    size_type floor = std::max(kth, min_overlap);
+                    auto end = std::remove_if(touched.begin(), touched.end(), [&](slot_t slot) {
+                        if (counters[slot] + remaining < floor) {
+                            --histogram[counters[slot]];
+                            counters[slot] = 0;
+                            return true;
+                        }
+                        return false;
+                    });
+                    touched.erase(end, touched.end());
+                }
+                if (admitting) {
+                    for (slot_t slot : list) {
+                        if (counters[slot] == 0) {
+                            touched.push_back(slot);
+                            ++histogram[0];
+                        }
+                        increment(slot);
+                    }
+                } else if (list.size() > touched.size() * search_ratio) {
+                    id_t id = lists[i].first;
+                    for (slot_t slot : touched) {
+                        const auto& ids = slots[slot].ids;
+                        if (std::binary_search(ids.begin(), ids.end(), id)) increment(slot);
+                    }
+                } else {
+                    for (slot_t slot : list) {
+                        if (counters[slot] != 0) increment(slot);
+                    }
+                }
+            }
+
+            for (slot_t slot : touched) {
+                if (counters[slot] >= min_overlap) ret.push_back(Match{slots[slot].key, counters[slot]});
+                counters[slot] = 0; // reset the scratch space for the next query
+            }
+            auto better = [](const Match& a, const Match& b) { return a.overlap > b.overlap || (a.overlap == b.overlap && a.key < b.key); };
+            if (ret.size() > k) {
+                std::nth_element(ret.begin(), ret.begin() + static_cast<std::ptrdiff_t>(k), ret.end(), better);
+                ret.resize(k);
+            }
+            std::sort(ret.begin(), ret.end(), better);
+            return ret;
+        }
+
+        // approximate number of bytes used
+        std::size_t memory_usage() const {
+            std::size_t r = sizeof(*this) + slots.capacity() * sizeof(Slot) + counters.capacity() * sizeof(count_t);
+            for (const auto& s : slots) r += s.ids.capacity() * sizeof(id_t) + s.positions.capacity() * sizeof(position_t);
+            for (const auto& p : postings) r += sizeof(p) + p.second.capacity() * sizeof(slot_t);
+            return r;
+        }
+
+    private:
+        using slot_t = std::uint32_t;
+        using count_t = std::uint32_t;
+        using position_t = std::uint32_t;
+
+        // if a posting list is this many times longer than the number of candidates, then the candidates are searched instead
+        static constexpr size_type search_ratio = 8;
+
+        struct Slot {
+            key_t key;
+            std::vector<id_t> ids; // ascending
+            std::vector<position_t> positions; // the position of this slot in the posting list of each id
+        };
+
+        std::unordered_map<id_t, std::vector<slot_t>> postings;
+        std::vector<Slot> slots;
+        std::vector<slot_t> free_slots;
+        std::unordered_map<key_t, slot_t> keys;
+
+        // query scratch space. a counter for each slot, and the slots with non-zero counters
+        mutable std::vector<count_t> counters;
+        mutable std::vector<slot_t> touched;
+};
+
+} // namespace sparse_distributed_representation
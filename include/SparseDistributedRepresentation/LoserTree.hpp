@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace sparse_distributed_representation {
+
+/**
+ * A tournament tree over k sources, which finds the smallest source in O(1) and updates in O(log k).
+ * This is used to merge k sorted sequences (k-way merge).
+ *
+ * Each internal node stores the loser of the match played at that node, and the overall winner is kept separately.
+ * After the winner's key changes (e.g. the winning sequence is advanced), only the path from its leaf to the root is replayed.
+ * Compared to a binary heap, this is one comparison per level instead of two.
+ *
+ * @tparam Less called as less(std::size_t a, std::size_t b), it compares the current keys of sources a and b.
+ *              it must be a strict weak ordering, and exhausted sources should compare greater than all others.
+ */
+template<typename Less>
+class LoserTree {
+    public:
+        LoserTree(std::size_t k, Less less) : k(k), nodes(k == 0 ? 1 : k), less(std::move(less)) {
+            nodes[0] = k == 0 ? 0 : build(1);
+        }
+
+        std::size_t size() const { return k; }
+
+        // the index of the source with the smallest key. k must be non-zero
+        std::size_t winner() const { return nodes[0]; }
+
+        // call after the winner's key has changed
+        void replay() {
+            std::size_t w = nodes[0];
+            for (std::size_t n = (w + k) / 2; n > 0; n /= 2) {
+                if (less(nodes[n], w)) std::swap(nodes[n], w);
+            }
+            nodes[0] = w;
+        }
+
+        // call after any of the keys have changed
+        void rebuild() {
+            if (k != 0) nodes[0] = build(1);
+        }
+
+    private:
+        // leaf i is node k + i, and the children of internal node n are 2n and 2n + 1.
+        // returns the winner of the subtree at node n, and stores the losers within it
+        std::size_t build(std::size_t n) {
+            if (n >= k) return n - k;
+            std::size_t l = build(2 * n);
+            std::size_t r = build(2 * n + 1);
+            if (less(r, l)) {
+                nodes[n] = l;
+                return r;
+            } else {
+                nodes[n] = r;
+                return l;
+            }
+        }
+
+        std::size_t k;
+        std::vector<std::size_t> nodes;
+        Less less;
+};
+
+} // namespace sparse_distributed_representation
@@ -1,5 +1,15 @@
 #pragma once
 
+#include <assert.h>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "SparseDistributedRepresentation/LoserTree.hpp"
+
 namespace sparse_distributed_representation {
 
 namespace matrix_utils {
@@ -15,17 +25,315 @@ struct row_info {
     typename major_t::data_type::const_iterator pos;
     typename major_t::data_type::const_iterator end;
     bool operator<(const row_info& other) const {
-        return pos->id() > other.pos->id(); // intentional greater
+        // intentional greater. ties go to the lower major id, so each minor is visited in ascending major order
+        if (pos->id() != other.pos->id()) return pos->id() > other.pos->id();
+        return id > other.id;
     }
 };
 
+// the offset of an id from the lowest id, for a counting sort over ids. it's an unsigned difference, so it can't overflow
+template<typename id_t>
+std::size_t id_offset(id_t id, id_t lo) {
+    return static_cast<std::size_t>(id) - static_cast<std::size_t>(lo);
+}
+
+// the inverse of id_offset
+template<typename id_t>
+id_t id_at_offset(id_t lo, std::size_t offset) {
+    return static_cast<id_t>(static_cast<std::size_t>(lo) + offset);
+}
+
+// the size of a dense array over the ids in [lo, hi] for a counting sort, if it's at most 4 times the number of elements.
+// otherwise 0, including when the range doesn't fit in a size_t (e.g. 64-bit ids at both ends of the domain)
+template<typename id_t>
+std::size_t dense_id_range(id_t lo, id_t hi, std::size_t elements) {
+    std::size_t span = id_offset(hi, lo);
+    if (span >= std::numeric_limits<std::size_t>::max() / 4) return 0;
+    std::size_t range = span + 1;
+    return range / 4 <= elements ? range : 0;
+}
+
+// whether a queue of row_infos can advance its top row in place, instead of popping it and pushing it back
+template<typename T, typename = void>
+struct advances_in_place : std::false_type {};
+
+template<typename T>
+struct advances_in_place<T, std::void_t<decltype(std::declval<T&>().advance_top())>> : std::true_type {};
+
+/**
+ * A k-way merge of rows, as an alternative to a std::priority_queue of row_infos in an OtherMajorView.
+ *
+ * Each row is a leaf of a loser tree. Advancing the top row replays one path of the tree, which is one comparison per level,
+ * instead of a heap's pop then push.
+ * All rows must be pushed before the first call to top or advance_top. The tree is built on the first call.
+ */
+template<typename row_info_t>
+class LoserTreeQueue {
+    public:
+        using value_type = row_info_t;
+
+        LoserTreeQueue() : tree(0, Less{nullptr}), built(false), live(0) {}
+
+        // the tree refers to the rows it was built over, so it's rebuilt by the copy instead of copied
+        LoserTreeQueue(const LoserTreeQueue& o) : infos(o.infos), tree(0, Less{nullptr}), built(false), live(o.live) {}
+
+        LoserTreeQueue& operator=(const LoserTreeQueue& o) {
+            infos = o.infos;
+            built = false;
+            live = o.live;
+            return *this;
+        }
+
+        bool empty() const { return live == 0; }
+        std::size_t size() const { return live; }
+
+        void push(const row_info_t& info) {
+            assert(!built && "rows can't be added once the merge has started");
+            infos.push_back(info);
+            ++live;
+        }
+
+        const row_info_t& top() const {
+            build();
+            return infos[tree.winner()];
+        }
+
+        void advance_top() {
+            build();
+            row_info_t& info = infos[tree.winner()];
+            if (++info.pos == info.end) --live;
+            tree.replay();
+        }
+
+    private:
+        struct Less {
+            const std::vector<row_info_t>* infos;
+
+            // exhausted rows lose to every other row
+            bool operator()(std::size_t a, std::size_t b) const {
+                const row_info_t& x = (*infos)[a];
+                const row_info_t& y = (*infos)[b];
+                if (x.pos == x.end) return false;
+                if (y.pos == y.end) return true;
+                return y < x; // row_info's ordering is intentionally greater
+            }
+        };
+
+        void build() const {
+            if (built) return;
+            tree = LoserTree<Less>(infos.size(), Less{&infos});
+            built = true;
+        }
+
+        std::vector<row_info_t> infos;
+        // built lazily, since rows are pushed through a const view
+        mutable LoserTree<Less> tree;
+        mutable bool built;
+        std::size_t live;
+};
+
+/**
+ * A bucket (radix) queue of rows, as an alternative to a std::priority_queue of row_infos in an OtherMajorView.
+ *
+ * There's one bucket per minor id, and each row waits in the bucket of its current element.
+ * The buckets are visited in ascending order, so each element is handled in O(1), except that each bucket is sorted by major id
+ * when it's reached. The rows' next elements always have greater minor ids, so they go into later buckets.
+ * This suits minor ids in a bounded, mostly occupied range, since the buckets span from 0 to the largest minor id.
+ * The minor ids must not be negative.
+ * All rows must be pushed before the first call to top or advance_top.
+ */
+template<typename row_info_t>
+class BucketQueue {
+    public:
+        using value_type = row_info_t;
+
+        BucketQueue() : settled(false), cursor(0), offset(0), live(0) {}
+
+        bool empty() const { return live == 0; }
+        std::size_t size() const { return live; }
+
+        void push(const row_info_t& info) {
+            assert(!settled && "rows can't be added once the merge has started");
+            add(info);
+            ++live;
+        }
+
+        const row_info_t& top() const {
+            settle();
+            return buckets[cursor][offset];
+        }
+
+        void advance_top() {
+            settle();
+            row_info_t info = buckets[cursor][offset];
+            if (++info.pos == info.end) {
+                --live;
+            } else {
+                add(info);
+            }
+            if (++offset == buckets[cursor].size()) {
+                buckets[cursor].clear();
+                offset = 0;
+                if (live != 0) {
+                    while (buckets[++cursor].empty());
+                    sort_bucket();
+                }
+            }
+        }
+
+    private:
+        void add(const row_info_t& info) const {
+            if constexpr(std::is_signed_v<std::decay_t<decltype(info.pos->id())>>) {
+                assert(info.pos->id() >= 0 && "minor ids must not be negative");
+            }
+            std::size_t id = static_cast<std::size_t>(info.pos->id());
+            if (id >= buckets.size()) buckets.resize(id + 1);
+            buckets[id].push_back(info);
+        }
+
+        void sort_bucket() const {
+            auto& b = buckets[cursor];
+            auto by_major = [](const row_info_t& x, const row_info_t& y) { return x.id < y.id; };
+            if (!std::is_sorted(b.cbegin(), b.cend(), by_major)) std::sort(b.begin(), b.end(), by_major);
+        }
+
+        // finds the first bucket, once all the rows have been pushed
+        void settle() const {
+            if (settled) return;
+            settled = true;
+            while (buckets[cursor].empty()) ++cursor;
+            sort_bucket();
+        }
+
+        // the buckets are settled lazily, since rows are pushed through a const view
+        mutable std::vector<std::vector<row_info_t>> buckets;
+        mutable bool settled;
+        mutable std::size_t cursor;
+        std::size_t offset;
+        std::size_t live;
+};
+
+/**
+ * Accumulates the elements of an output row in same_mul (Gustavson's method).
+ *
+ * A row is computed in two passes. The symbolic pass touches each output column, then prepare assigns each column a slot
+ * and gives the number of columns, so the output row can be sized. The numeric pass adds each product to its column's slot.
+ * Finally, flush outputs the columns in ascending order and resets for the next row.
+ *
+ * @tparam elem_t the element type of the output rows
+ * @tparam slots_t maps a column id to its slot. see DenseSlots and HashSlots
+ */
+template<typename elem_t, typename slots_t>
+class SparseAccumulator {
+    public:
+        using id_type = typename elem_t::id_type;
+        using data_type = typename elem_t::data_type;
+
+        void touch(id_type id) {
+            if (slots.insert(id)) columns.push_back(id);
+        }
+
+        // returns the number of touched columns
+        std::size_t prepare() {
+            std::sort(columns.begin(), columns.end());
+            for (std::size_t i = 0; i < columns.size(); ++i) slots.set(columns[i], i);
+            values.resize(columns.size());
+            filled.assign(columns.size(), false);
+            return columns.size();
+        }
+
+        // the column must have been touched
+        void add(id_type id, data_type&& data) {
+            std::size_t i = slots.get(id);
+            if (filled[i]) {
+                values[i].ori(data);
+            } else {
+                values[i] = std::move(data);
+                filled[i] = true;
+            }
+        }
+
+        // calls output(elem_t&&) for each relevant column, in ascending order
+        template<typename Output>
+        void flush(Output&& output) {
+            for (std::size_t i = 0; i < columns.size(); ++i) {
+                if (filled[i] && values[i].relevant()) output(elem_t(columns[i], std::move(values[i])));
+            }
+            slots.reset(columns);
+            columns.clear();
+        }
+
+    private:
+        slots_t slots;
+        std::vector<id_type> columns;
+        std::vector<data_type> values;
+        std::vector<bool> filled;
+};
+
+// a slot per column id, in an array that spans from 0 to the largest column id. the column ids must not be negative
+template<typename id_t>
+class DenseSlots {
+    public:
+        // returns true if the id wasn't already in
+        bool insert(id_t id) {
+            if constexpr(std::is_signed_v<id_t>) {
+                assert(id >= 0 && "column ids must not be negative");
+            }
+            std::size_t i = static_cast<std::size_t>(id);
+            if (i >= slots.size()) slots.resize(i + 1, none);
+            if (slots[i] != none) return false;
+            slots[i] = 0;
+            return true;
+        }
+
+        void set(id_t id, std::size_t slot) { slots[static_cast<std::size_t>(id)] = slot; }
+        std::size_t get(id_t id) const { return slots[static_cast<std::size_t>(id)]; }
+
+        // only the inserted ids are reset, so the array is reused between rows without clearing all of it
+        void reset(const std::vector<id_t>& ids) {
+            for (id_t id : ids) slots[static_cast<std::size_t>(id)] = none;
+        }
+
+    private:
+        static constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+        std::vector<std::size_t> slots;
+};
+
+// a slot per column id, in a hash map. this suits huge or sparse column id spaces
+template<typename id_t>
+class HashSlots {
+    public:
+        bool insert(id_t id) { return slots.emplace(id, 0).second; }
+        void set(id_t id, std::size_t slot) { slots.find(id)->second = slot; }
+        std::size_t get(id_t id) const { return slots.find(id)->second; }
+        void reset(const std::vector<id_t>&) { slots.clear(); }
+
+    private:
+        std::unordered_map<id_t, std::size_t> slots;
+};
+
+// a dense sparse accumulator (SPA) for same_mul
+template<typename elem_t>
+using DenseAccumulator = SparseAccumulator<elem_t, DenseSlots<typename elem_t::id_type>>;
+
+// a hash accumulator for same_mul
+template<typename elem_t>
+using HashAccumulator = SparseAccumulator<elem_t, HashSlots<typename elem_t::id_type>>;
+
+// whether a container can reserve capacity ahead of time
+template<typename T, typename = void>
+struct reservable : std::false_type {};
+
+template<typename T>
+struct reservable<T, std::void_t<decltype(std::declval<T&>().reserve(std::size_t()))>> : std::true_type {};
+
 /**
  * this gives an iterator-like interface, which provides elements of a matrix in a view opposite to how it is stored
  * e.g. viewing the elements of a row-wise matrix in a column-wise format
  *  the elements are provided as follows
  *      [ 1 2 ]
  *      [ 3 4 ]  ->  1 3 2 4
- * @tparam priority_queue_container_t a priority_queue containing row_info objects
+ * @tparam priority_queue_container_t a priority_queue containing row_info objects, or a LoserTreeQueue or BucketQueue
  */
 template<typename priority_queue_container_t>
 class OtherMajorView {
@@ -39,7 +347,7 @@ class OtherMajorView {
     public:
         OtherMajorView() {}
 
-        OtherMajorView(priority_queue_container_t&& q) : row_infos(q) {}
+        OtherMajorView(priority_queue_container_t&& q) : row_infos(std::move(q)) {}
 
         // dereferencing OtherMajorView yields a Position
         struct Position {
@@ -67,11 +375,15 @@ class OtherMajorView {
         }
 
         void operator++() {
-            row_info_type elem = row_infos.top();
-            row_infos.pop();
-            ++elem.pos;
-            if (elem.pos != elem.end) {
-                row_infos.push(elem);
+            if constexpr(advances_in_place<priority_queue_container_t>::value) {
+                row_infos.advance_top();
+            } else {
+                row_info_type elem = row_infos.top();
+                row_infos.pop();
+                ++elem.pos;
+                if (elem.pos != elem.end) {
+                    row_infos.push(elem);
+                }
             }
         }
 };
@@ -106,9 +418,11 @@ class BucketOutputAccumulator {
     private:
         T& output;
         typename T::value_type bucket;
+        // the default bucket isn't an element, and must not be flushed (its data might still be relevant)
+        bool occupied;
 
         void flush() {
-            if (bucket.data().relevant()) {
+            if (occupied && bucket.data().relevant()) {
                 if constexpr(flist_like<typename T::container_type>::value) {
                     output_it = output.insert_after(output_it, std::move(bucket));
                 } else {
@@ -122,15 +436,17 @@ class BucketOutputAccumulator {
     public:
         BucketOutputAccumulator(T& output) : output(output),
                                              bucket(),
+                                             occupied(false),
                                              output_it(get_output_it(output)) {}
 
         void operator()(typename T::value_type&& elem) {
-            if (bucket.id() == elem.id()) {
+            if (occupied && bucket.id() == elem.id()) {
                 bucket.data().ori(elem.data());
             } else {
                 flush();
                 // bucket is moved-from after the call to flush
                 bucket = std::move(elem);
+                occupied = true;
             }
         }
 
@@ -167,7 +483,7 @@ class BucketOutputAppender {
 
     public:
         BucketOutputAppender(T& output) : output(output),
-                                          bucket(),
+                                          bucket(typename T::value_type::id_type(), output.template make_empty<typename T::value_type::data_type>()),
                                           output_it(get_output_it(output)),
                                           bucket_it(get_output_it(bucket.data())) {}
 
@@ -175,7 +491,8 @@ class BucketOutputAppender {
             if (id != bucket.id()) {
                 flush();
                 // bucket is moved-from after the call to flush
-                bucket = typename T::value_type(id);
+                // the row uses the same allocator as the output, so it can be moved into it without copying
+                bucket = typename T::value_type(id, output.template make_empty<typename T::value_type::data_type>());
                 bucket_it = get_output_it(bucket.data());
             }
             if constexpr(flist_like<typename T::value_type::data_type::container_type>::value) {
@@ -190,6 +507,53 @@ class BucketOutputAppender {
         }
 };
 
+/**
+ * Computes the output rows of same_mul with Gustavson's method.
+ * This keeps the accumulator and the scratch space between rows, so one should be reused for many rows (but not by concurrent threads).
+ *
+ * @tparam accumulator_t e.g. a DenseAccumulator or HashAccumulator of the output row's elements.
+ * @tparam this_elem_t the element type of the row.
+ * @tparam arg_row_t the row type of the arg matrix.
+ */
+template<typename accumulator_t, typename this_elem_t, typename arg_row_t>
+class GustavsonRow {
+    public:
+        // computes the product of the row and the arg matrix into output, which must be empty
+        template<typename row_data_t, typename arg_matrix_t, typename output_t>
+        void operator()(const row_data_t& row, const arg_matrix_t& arg, output_t& output) {
+            using output_data_t = typename output_t::value_type::data_type;
+            selected.clear();
+            auto both_visitor = [&](auto this_pos, auto arg_pos) {
+                selected.emplace_back(&*this_pos, &*arg_pos);
+            };
+            const_cast<row_data_t&>(row).andv(const_cast<arg_matrix_t&>(arg), both_visitor);
+
+            // symbolic pass
+            for (const auto& s : selected) {
+                for (const auto& elem : s.second->data()) accumulator.touch(elem.id());
+            }
+            [[maybe_unused]] std::size_t columns = accumulator.prepare();
+            if constexpr(reservable<typename output_t::container_type>::value) {
+                output.reserve(static_cast<typename output_t::size_type>(columns));
+            }
+
+            // numeric pass
+            for (const auto& s : selected) {
+                for (const auto& elem : s.second->data()) {
+                    accumulator.add(elem.id(), s.first->data().template ande<output_data_t>(elem.data()));
+                }
+            }
+
+            BucketOutputAccumulator<output_t> sink(output);
+            accumulator.flush(sink);
+        }
+
+    private:
+        accumulator_t accumulator;
+        // the elements of the row, and the rows of the arg they select
+        std::vector<std::pair<const this_elem_t*, const arg_row_t*>> selected;
+};
+
 } // namespace
 
 } // namespace
\ No newline at end of file
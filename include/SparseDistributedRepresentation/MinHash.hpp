@@ -0,0 +1,218 @@
+#pragma once
+
+#include <algorithm>
+#include <assert.h>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "SparseDistributedRepresentation/SDR.hpp"
+
+namespace sparse_distributed_representation {
+
+namespace minhash {
+
+// the splitmix64 finalizer. the same on every platform, unlike std::hash
+inline std::uint64_t mix(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+} // namespace minhash
+
+/**
+ * Computes MinHash signatures of SDRs.
+ * The fraction of positions where two signatures are equal estimates the jaccard similarity of the SDRs.
+ *
+ * The hash functions only depend on the seed and the number of hashes,
+ * so signatures can be stored and compared with signatures computed later (or elsewhere).
+ */
+class MinHasher {
+    public:
+        using value_type = std::uint32_t;
+        using Signature = std::vector<value_type>;
+
+        MinHasher(std::size_t num_hashes, std::uint64_t seed = 0) : seed_(seed) {
+            salts.reserve(num_hashes);
+            std::uint64_t state = seed;
+            for (std::size_t i = 0; i < num_hashes; ++i) {
+                state = minhash::mix(state);
+                salts.push_back(state);
+            }
+        }
+
+        std::size_t size() const { return salts.size(); }
+        std::uint64_t seed() const { return seed_; }
+
+        // the signature of the elements in [begin, end), in a single pass
+        template<typename Iterator>
+        Signature signature(Iterator begin, Iterator end) const {
+            Signature sig(salts.size(), std::numeric_limits<value_type>::max());
+            for (auto it = begin; it != end; ++it) {
+                std::uint64_t id = static_cast<std::uint64_t>(it->id());
+                for (std::size_t i = 0; i < salts.size(); ++i) {
+                    value_type h = static_cast<value_type>(minhash::mix(id ^ salts[i]));
+                    if (h < sig[i]) sig[i] = h;
+                }
+            }
+            return sig;
+        }
+
+        template<typename SDRElem_t, typename container_t>
+        Signature signature(const SDR<SDRElem_t, container_t>& sdr) const {
+            return signature(sdr.cbegin(), sdr.cend());
+        }
+
+        // estimated jaccard similarity of the SDRs which gave these signatures
+        static double similarity(const Signature& a, const Signature& b) {
+            assert(a.size() == b.size());
+            if (a.empty()) return 0;
+            std::size_t same = 0;
+            for (std::size_t i = 0; i < a.size(); ++i) {
+                same += a[i] == b[i];
+            }
+            return static_cast<double>(same) / static_cast<double>(a.size());
+        }
+
+    private:
+        std::uint64_t seed_;
+        std::vector<std::uint64_t> salts; // one per hash function
+};
+
+/**
+ * Finds candidates for the stored SDRs which are similar to a query, with locality sensitive hashing.
+ *
+ * Each signature is split into bands of rows. Stored SDRs which have an identical band with the query are candidates.
+ * With b bands of r rows, SDRs with jaccard similarity s are candidates with probability 1 - (1 - s^r)^b.
+ *
+ * @tparam key_t identifies each stored SDR.
+ */
+template<typename key_t = std::size_t>
+class LSHIndex {
+    public:
+        using key_type = key_t;
+        using Signature = MinHasher::Signature;
+
+        struct Match {
+            key_t key;
+            std::size_t overlap;
+
+            bool operator==(const Match& o) const { return key == o.key && overlap == o.overlap; }
+        };
+
+        // there must be at least one band and one row
+        LSHIndex(std::size_t bands, std::size_t rows, std::uint64_t seed = 0) : hasher(bands * rows, seed), rows(rows), buckets(bands) {
+            assert(bands != 0 && rows != 0);
+        }
+
+        const MinHasher& get_hasher() const { return hasher; }
+        std::size_t size() const { return signatures.size(); }
+        bool contains(const key_t& key) const { return signatures.find(key) != signatures.end(); }
+
+        // the stored signature, or nullptr if the key isn't stored
+        const Signature* signature(const key_t& key) const {
+            auto it = signatures.find(key);
+            return it == signatures.end() ? nullptr : &it->second;
+        }
+
+        // stores a signature (e.g. one which was persisted), which must be from a hasher of the same size.
+        // if the key is already stored, then it is replaced
+        void insert(const key_t& key, Signature sig) {
+            assert(sig.size() == hasher.size());
+            erase(key);
+            for (std::size_t band = 0; band < buckets.size(); ++band) {
+                buckets[band][band_hash(sig, band)].push_back(key);
+            }
+            signatures.emplace(key, std::move(sig));
+        }
+
+        template<typename SDRElem_t, typename container_t>
+        void insert(const key_t& key, const SDR<SDRElem_t, container_t>& sdr) {
+            insert(key, hasher.signature(sdr));
+        }
+
+        // returns false if the key isn't stored
+        bool erase(const key_t& key) {
+            auto it = signatures.find(key);
+            if (it == signatures.end()) return false;
+            for (std::size_t band = 0; band < buckets.size(); ++band) {
+                auto bucket = buckets[band].find(band_hash(it->second, band));
+                assert(bucket != buckets[band].end());
+                auto& keys = bucket->second;
+                auto pos = std::find(keys.begin(), keys.end(), key);
+                assert(pos != keys.end());
+                *pos = keys.back();
+                keys.pop_back();
+                if (keys.empty()) buckets[band].erase(bucket);
+            }
+            signatures.erase(it);
+            return true;
+        }
+
+        void clear() {
+            for (auto& b : buckets) b.clear();
+            signatures.clear();
+        }
+
+        // the stored SDRs which share a band with the signature, without duplicates
+        std::vector<key_t> candidates(const Signature& sig) const {
+            assert(sig.size() == hasher.size());
+            std::vector<key_t> ret;
+            std::unordered_set<key_t> seen;
+            for (std::size_t band = 0; band < buckets.size(); ++band) {
+                auto bucket = buckets[band].find(band_hash(sig, band));
+                if (bucket == buckets[band].end()) continue;
+                for (const key_t& key : bucket->second) {
+                    if (seen.insert(key).second) ret.push_back(key);
+                }
+            }
+            return ret;
+        }
+
+        template<typename SDRElem_t, typename container_t>
+        std::vector<key_t> candidates(const SDR<SDRElem_t, container_t>& query) const {
+            return candidates(hasher.signature(query));
+        }
+
+        /**
+         * finds the candidates, then ranks them by their exact overlap (ands) with the query.
+         *
+         * @param lookup gives the stored SDR for a key.
+         * @return up to k matches, by descending overlap (ties by ascending key).
+         */
+        template<typename SDRElem_t, typename container_t, typename Lookup>
+        std::vector<Match> top_k(const SDR<SDRElem_t, container_t>& query, std::size_t k, Lookup&& lookup) const {
+            std::vector<Match> ret;
+            for (const key_t& key : candidates(query)) {
+                std::size_t overlap = query.ands(lookup(key));
+                if (overlap != 0) ret.push_back(Match{key, overlap});
+            }
+            auto better = [](const Match& a, const Match& b) { return a.overlap > b.overlap || (a.overlap == b.overlap && a.key < b.key); };
+            if (ret.size() > k) {
+                std::nth_element(ret.begin(), ret.begin() + static_cast<std::ptrdiff_t>(k), ret.end(), better);
+                ret.resize(k);
+            }
+            std::sort(ret.begin(), ret.end(), better);
+            return ret;
+        }
+
+    private:
+        std::uint64_t band_hash(const Signature& sig, std::size_t band) const {
+            std::uint64_t h = band;
+            for (std::size_t i = band * rows; i < (band + 1) * rows; ++i) {
+                h = minhash::mix(h ^ sig[i]);
+            }
+            return h;
+        }
+
+        MinHasher hasher;
+        std::size_t rows;
+        std::vector<std::unordered_map<std::uint64_t, std::vector<key_t>>> buckets; // for each band, band hash -> keys
+        std::unordered_map<key_t, Signature> signatures;
+};
+
+} // namespace sparse_distributed_representation
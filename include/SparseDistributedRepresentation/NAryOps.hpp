@@ -0,0 +1,290 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include "SparseDistributedRepresentation/SDR.hpp"
+#include "SparseDistributedRepresentation/SDRRange.hpp"
+#include "SparseDistributedRepresentation/LoserTree.hpp"
+
+namespace sparse_distributed_representation {
+
+// ops between N SDRs at once, instead of chaining binary ops.
+// each op takes a range (e.g. a std::vector) of SDRs, or pointers to SDRs, or std::reference_wrappers of SDRs.
+// the SDRs must have the same type, but any container can be used.
+
+namespace nary_ops {
+
+// void is replaced with the default (from the SDR type in the range)
+template<typename T, typename default_t>
+using or_default = std::conditional_t<std::is_void_v<T>, default_t, T>;
+
+// the container type for the result elements, which is the SDRs' container if the element type is unchanged
+template<typename container_t, typename elem_t>
+using container_for = std::conditional_t<std::is_same_v<typename container_t::value_type, elem_t>, container_t, replace_value_type<container_t, elem_t>>;
+
+// the position in one of the SDRs
+template<typename sdr_t>
+struct Cursor {
+    typename sdr_t::const_iterator pos;
+    typename sdr_t::const_iterator end;
+};
+
+// the first position at or after pos with an id not less than the id.
+// this uses the same search as the binary andv: galloping for vectors, the container's lower_bound for sets, and linear otherwise
+template<typename sdr_t, typename id_t>
+typename sdr_t::const_iterator seek(const sdr_t& sdr, typename sdr_t::const_iterator pos, typename sdr_t::const_iterator end, const id_t& id) {
+    if (pos == end || !(pos->id() < id)) return pos;
+    if constexpr(sdr_t::uses_vector_like) {
+        return gallop_lower_bound(pos, end, id);
+    } else if constexpr(sdr_t::uses_set_like) {
+        return sdr.lower_bound(typename sdr_t::value_type(id));
+    } else {
+        while (pos != end && pos->id() < id) ++pos;
+        return pos;
+    }
+}
+
+// an empty result, made from the first SDR so it uses the same allocator
+template<typename ret_sdr_t, typename Range>
+ret_sdr_t make_result(const Range& sdrs) {
+    if (std::begin(sdrs) == std::end(sdrs)) return ret_sdr_t();
+    return deref(*std::begin(sdrs)).template make_empty<ret_sdr_t>();
+}
+
+} // namespace nary_ops
+
+/**
+ * N-ary or visitor. The SDRs are merged in a single pass, with a loser tree.
+ * 
+ * @param visitor called once for each id in any of the SDRs, in ascending order.
+ *                it is called as visitor(const std::vector<const_iterator>& group),
+ *                where the group has the position of the id in each SDR which contains it (in the order of the SDRs).
+ */
+template<typename Range, typename Visitor>
+void orv(const Range& sdrs, Visitor visitor) {
+    using sdr_t = nary_ops::sdr_type<Range>;
+    using const_iterator = typename sdr_t::const_iterator;
+    std::vector<nary_ops::Cursor<sdr_t>> cursors;
+    for (const auto& sdr : sdrs) {
+        const sdr_t& s = nary_ops::deref(sdr);
+        cursors.push_back({s.cbegin(), s.cend()});
+    }
+    if (cursors.empty()) return;
+
+    auto less = [&](std::size_t a, std::size_t b) {
+        const auto& ca = cursors[a];
+        const auto& cb = cursors[b];
+        if (ca.pos == ca.end) return false;
+        if (cb.pos == cb.end) return true;
+        // ties are broken by position in the range, so each group is in the order of the SDRs
+        return ca.pos->id() < cb.pos->id() || (!(cb.pos->id() < ca.pos->id()) && a < b);
+    };
+    LoserTree<decltype(less)> tree(cursors.size(), less);
+
+    std::vector<const_iterator> group;
+    group.reserve(cursors.size());
+    while (true) {
+        auto& first = cursors[tree.winner()];
+        if (first.pos == first.end) break;
+        auto id = first.pos->id();
+        group.clear();
+        while (true) {
+            auto& c = cursors[tree.winner()];
+            if (c.pos == c.end || c.pos->id() != id) break;
+            group.push_back(c.pos++);
+            tree.replay();
+        }
+        visitor(const_cast<const std::vector<const_iterator>&>(group));
+    }
+}
+
+/**
+ * N-ary or elements. Same result as chaining ore (or ori) over the SDRs, but in a single pass.
+ * The data of elements with the same id are combined with ori.
+ * 
+ * @tparam ret_t the result element type. void is the same as the SDRs' element type.
+ * @tparam c_ret_t the result container type. void is the same as the SDRs' container type.
+ */
+template<typename ret_t = void, typename c_ret_t = void, typename Range>
+auto ore(const Range& sdrs) {
+    using sdr_t = nary_ops::sdr_type<Range>;
+    static_assert(is_sdr<sdr_t>::value, "ore: the range must hold SDRs of one type (or pointers / reference_wrappers to them). "
+                                        "SDRs with different element or container types can't be merged in one call; "
+                                        "convert them to one type first, or chain the binary ore");
+    using elem_t = nary_ops::or_default<ret_t, typename sdr_t::value_type>;
+    using container_t = nary_ops::or_default<c_ret_t, nary_ops::container_for<typename sdr_t::container_type, elem_t>>;
+    using ret_sdr_t = SDR<elem_t, container_t>;
+    ret_sdr_t r = nary_ops::make_result<ret_sdr_t>(sdrs);
+    if constexpr(vector_like<container_t>::value) {
+        // the result can't be larger than all of the SDRs together
+        typename ret_sdr_t::size_type total = 0;
+        for (const auto& sdr : sdrs) total += nary_ops::deref(sdr).size();
+        r.reserve(total);
+    }
+    nary_ops::Appender<ret_sdr_t> append(r);
+    orv(sdrs, [&](const auto& group) {
+        elem_t elem(*group.front());
+        for (auto it = std::next(group.begin()); it != group.end(); ++it) {
+            elem.data().ori((*it)->data());
+        }
+        append(std::move(elem));
+    });
+    return r; // nrvo
+}
+
+/**
+ * Threshold voting. The ids which are in at least k of the SDRs.
+ * This is a single merge (the same as ore), where each id's count is the number of SDRs which contain it.
+ * The data of elements with the same id are combined with ori.
+ * 
+ * k = 1 is the same as ore, and k = the number of SDRs is the same as ande (except for the data).
+ * 
+ * @tparam ret_t the result element type. void is the same as the SDRs' element type.
+ * @tparam c_ret_t the result container type. void is the same as the SDRs' container type.
+ */
+template<typename ret_t = void, typename c_ret_t = void, typename Range>
+auto vote(const Range& sdrs, std::size_t k) {
+    using sdr_t = nary_ops::sdr_type<Range>;
+    using elem_t = nary_ops::or_default<ret_t, typename sdr_t::value_type>;
+    using container_t = nary_ops::or_default<c_ret_t, nary_ops::container_for<typename sdr_t::container_type, elem_t>>;
+    using ret_sdr_t = SDR<elem_t, container_t>;
+    ret_sdr_t r = nary_ops::make_result<ret_sdr_t>(sdrs);
+    nary_ops::Appender<ret_sdr_t> append(r);
+    orv(sdrs, [&](const auto& group) {
+        if (group.size() < k) return;
+        elem_t elem(*group.front());
+        for (auto it = std::next(group.begin()); it != group.end(); ++it) {
+            elem.data().ori((*it)->data());
+        }
+        append(std::move(elem));
+    });
+    return r; // nrvo
+}
+
+/**
+ * Threshold voting size. Same as vote(sdrs, k).size(), without building the result.
+ */
+template<typename Range>
+auto votes(const Range& sdrs, std::size_t k) {
+    typename nary_ops::sdr_type<Range>::size_type r = 0;
+    orv(sdrs, [&](const auto& group) {
+        if (group.size() >= k) ++r;
+    });
+    return r;
+}
+
+/**
+ * N-ary and visitor. The smallest SDR is walked, and the others are searched for each of its ids.
+ * If an id is missing from another SDR, then the smallest SDR skips ahead to that SDR's next id.
+ * 
+ * @param visitor called once for each id in all of the SDRs, in ascending order.
+ *                it is called as visitor(const std::vector<const_iterator>& group),
+ *                where the group has the position of the id in each SDR (in the order of the SDRs).
+ */
+template<typename Range, typename Visitor>
+void andv(const Range& sdrs, Visitor visitor) {
+    using sdr_t = nary_ops::sdr_type<Range>;
+    using const_iterator = typename sdr_t::const_iterator;
+    std::vector<const sdr_t*> operands;
+    std::vector<nary_ops::Cursor<sdr_t>> cursors;
+    for (const auto& sdr : sdrs) {
+        const sdr_t& s = nary_ops::deref(sdr);
+        operands.push_back(&s);
+        cursors.push_back({s.cbegin(), s.cend()});
+    }
+    if (operands.empty()) return;
+
+    // smallest first
+    std::vector<std::size_t> order(operands.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return operands[a]->size() < operands[b]->size(); });
+
+    std::vector<const_iterator> group(operands.size());
+    const sdr_t& smallest = *operands[order.front()];
+    auto& s = cursors[order.front()];
+    while (s.pos != s.end) {
+        auto id = s.pos->id();
+        bool match = true;
+        for (auto it = std::next(order.begin()); it != order.end(); ++it) {
+            auto& c = cursors[*it];
+            c.pos = nary_ops::seek(*operands[*it], c.pos, c.end, id);
+            if (c.pos == c.end) return;
+            if (c.pos->id() != id) {
+                s.pos = nary_ops::seek(smallest, s.pos, s.end, c.pos->id());
+                match = false;
+                break;
+            }
+        }
+        if (match) {
+            for (std::size_t i = 0; i < cursors.size(); ++i) group[i] = cursors[i].pos;
+            visitor(const_cast<const std::vector<const_iterator>&>(group));
+            ++s.pos;
+        }
+    }
+}
+
+/**
+ * N-ary and elements. Same result as chaining ande (or andi) over the SDRs.
+ * The data of elements with the same id are combined with andi, and irrelevant elements are not placed in the result.
+ * 
+ * @tparam ret_t the result element type. void is the same as the SDRs' element type.
+ * @tparam c_ret_t the result container type. void is the same as the SDRs' container type.
+ */
+template<typename ret_t = void, typename c_ret_t = void, typename Range>
+auto ande(const Range& sdrs) {
+    using sdr_t = nary_ops::sdr_type<Range>;
+    using elem_t = nary_ops::or_default<ret_t, typename sdr_t::value_type>;
+    using container_t = nary_ops::or_default<c_ret_t, nary_ops::container_for<typename sdr_t::container_type, elem_t>>;
+    using ret_sdr_t = SDR<elem_t, container_t>;
+    ret_sdr_t r = nary_ops::make_result<ret_sdr_t>(sdrs);
+    if constexpr(vector_like<container_t>::value) {
+        // the result can't be larger than the smallest SDR
+        typename ret_sdr_t::size_type smallest = 0;
+        bool first = true;
+        for (const auto& sdr : sdrs) {
+            auto size = nary_ops::deref(sdr).size();
+            if (first || size < smallest) smallest = size;
+            first = false;
+        }
+        r.reserve(smallest);
+    }
+    nary_ops::Appender<ret_sdr_t> append(r);
+    andv(sdrs, [&](const auto& group) {
+        elem_t elem(*group.front());
+        for (auto it = std::next(group.begin()); it != group.end(); ++it) {
+            elem.data().andi((*it)->data());
+        }
+        if (elem.data().relevant()) append(std::move(elem));
+    });
+    if constexpr(vector_like<container_t>::value) r.shrink_to_fit();
+    return r; // nrvo
+}
+
+/**
+ * N-ary and size. Same as ande(sdrs).size(), without building the result.
+ */
+template<typename Range>
+auto ands(const Range& sdrs) {
+    using sdr_t = nary_ops::sdr_type<Range>;
+    using data_t = typename sdr_t::value_type::data_type;
+    typename sdr_t::size_type r = 0;
+    andv(sdrs, [&](const auto& group) {
+        if constexpr(std::is_same_v<data_t, EmptyData>) {
+            ++r;
+        } else {
+            data_t data(group.front()->data());
+            for (auto it = std::next(group.begin()); it != group.end(); ++it) {
+                data.andi((*it)->data());
+            }
+            if (data.relevant()) ++r;
+        }
+    });
+    return r;
+}
+
+} // namespace sparse_distributed_representation
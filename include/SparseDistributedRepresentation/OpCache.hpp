@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+#include "SparseDistributedRepresentation/InternPool.hpp"
+
+namespace sparse_distributed_representation {
+
+/**
+ * A bounded LRU cache of op results between interned SDRs.
+ *
+ * Each entry is keyed on the identity of both operands (their InternHandles) and the op.
+ * Interned SDRs are immutable and a handle only ever refers to one SDR, so a cached result is always the same as calling the op.
+ * The least recently used entry is evicted once there are more than the capacity.
+ * If the pool is cleared, then the cache must be cleared as well, since a new SDR could reuse the address of an old one.
+ *
+ * The size ops (ands, ors, xors, rms) only cache the size.
+ * The element ops (ande, ore, xore, rme) cache the result, and return a copy of it, the same as the ops themselves.
+ */
+template<typename SDRElem_t = SDRElem<>, typename container_t = std::vector<SDRElem_t>>
+class OpCache {
+    public:
+        using sdr_type = SDR<SDRElem_t, container_t>;
+        using handle = InternHandle<SDRElem_t, container_t>;
+        using size_type = typename sdr_type::size_type;
+
+        enum class Op : std::uint8_t { ANDE, ANDS, ORE, ORS, XORE, XORS, RME, RMS };
+
+        OpCache(std::size_t capacity) : capacity_(capacity), hits_(0), misses_(0) {}
+
+        size_type ands(handle a, handle b) { return size_op(Op::ANDS, a, b, [](const sdr_type& x, const sdr_type& y) { return x.ands(y); }); }
+        size_type ors(handle a, handle b) { return size_op(Op::ORS, a, b, [](const sdr_type& x, const sdr_type& y) { return x.ors(y); }); }
+        size_type xors(handle a, handle b) { return size_op(Op::XORS, a, b, [](const sdr_type& x, const sdr_type& y) { return x.xors(y); }); }
+        size_type rms(handle a, handle b) { return size_op(Op::RMS, a, b, [](const sdr_type& x, const sdr_type& y) { return x.rms(y); }); }
+
+        sdr_type ande(handle a, handle b) { return element_op(Op::ANDE, a, b, [](const sdr_type& x, const sdr_type& y) { return x.ande(y); }); }
+        sdr_type ore(handle a, handle b) { return element_op(Op::ORE, a, b, [](const sdr_type& x, const sdr_type& y) { return x.ore(y); }); }
+        sdr_type xore(handle a, handle b) { return element_op(Op::XORE, a, b, [](const sdr_type& x, const sdr_type& y) { return x.xore(y); }); }
+        sdr_type rme(handle a, handle b) { return element_op(Op::RME, a, b, [](const sdr_type& x, const sdr_type& y) { return x.rme(y); }); }
+
+        std::size_t capacity() const { return capacity_; }
+        std::size_t size() const { return entries.size(); }
+        std::size_t hits() const { return hits_; }
+        std::size_t misses() const { return misses_; }
+
+        // removes every entry. the counters are kept
+        void clear() {
+            index.clear();
+            entries.clear();
+        }
+
+        void reset_counters() {
+            hits_ = 0;
+            misses_ = 0;
+        }
+
+    private:
+        struct Key {
+            handle a;
+            handle b;
+            Op op;
+
+            bool operator==(const Key& o) const { return a == o.a && b == o.b && op == o.op; }
+        };
+
+        struct KeyHash {
+            std::size_t operator()(const Key& k) const {
+                std::uint64_t h = minhash::mix(std::hash<handle>()(k.a) ^ static_cast<std::uint64_t>(k.op));
+                return static_cast<std::size_t>(minhash::mix(h ^ std::hash<handle>()(k.b)));
+            }
+        };
+
+        struct Entry {
+            Key key;
+            size_type size;
+            sdr_type result;
+        };
+
+        // on a hit, moves the entry to the front and returns it. on a miss, returns nullptr
+        const Entry* find(const Key& key) {
+            auto it = index.find(key);
+            if (it == index.end()) {
+                ++misses_;
+                return nullptr;
+            }
+            ++hits_;
+            entries.splice(entries.begin(), entries, it->second);
+            return &entries.front();
+        }
+
+        // adds the entry at the front, evicting from the back
+        void add(Entry&& entry) {
+            if (capacity_ == 0) return;
+            entries.push_front(std::move(entry));
+            index.emplace(entries.front().key, entries.begin());
+            if (entries.size() > capacity_) {
+                index.erase(entries.back().key);
+                entries.pop_back();
+            }
+        }
+
+        template<typename Fn>
+        size_type size_op(Op op, handle a, handle b, Fn fn) {
+            Key key{a, b, op};
+            if (const Entry* e = find(key)) return e->size;
+            size_type ret = fn(*a, *b);
+            add(Entry{key, ret, sdr_type()});
+            return ret;
+        }
+
+        template<typename Fn>
+        sdr_type element_op(Op op, handle a, handle b, Fn fn) {
+            Key key{a, b, op};
+            if (const Entry* e = find(key)) return e->result;
+            sdr_type ret = fn(*a, *b);
+            add(Entry{key, 0, ret});
+            return ret;
+        }
+
+        std::size_t capacity_;
+        std::size_t hits_;
+        std::size_t misses_;
+        std::list<Entry> entries; // most recently used first
+        std::unordered_map<Key, typename std::list<Entry>::iterator, KeyHash> index;
+};
+
+} // namespace sparse_distributed_representation
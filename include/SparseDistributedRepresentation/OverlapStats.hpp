@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cmath>
+
+namespace sparse_distributed_representation {
+
+/**
+ * The sizes of the results of the ops between two SDRs, a and b.
+ * This is returned by a.overlap_stats(b), which computes all of them together.
+ *
+ * The ands, xors and rms sizes account for the relevance of the data, the same as SDR::ands, SDR::xors and SDR::rms.
+ */
+template<typename size_type>
+struct OverlapStats {
+    size_type a_size; // a.size()
+    size_type b_size; // b.size()
+    size_type ands; // a.ands(b)
+    size_type ors; // a.ors(b)
+    size_type xors; // a.xors(b)
+    size_type rms; // a.rms(b)
+
+    // intersection over union. 0 if both are empty
+    double jaccard() const {
+        return ors == 0 ? 0 : static_cast<double>(ands) / ors;
+    }
+
+    // twice the intersection over the sum of the sizes. 0 if both are empty
+    double dice() const {
+        size_type total = a_size + b_size;
+        return total == 0 ? 0 : 2.0 * ands / total;
+    }
+
+    // the cosine similarity, if the SDRs are viewed as binary vectors. 0 if either is empty
+    double cosine() const {
+        return a_size == 0 || b_size == 0 ? 0 : ands / std::sqrt(static_cast<double>(a_size) * b_size);
+    }
+
+    bool operator==(const OverlapStats& o) const {
+        return a_size == o.a_size && b_size == o.b_size && ands == o.ands && ors == o.ors && xors == o.xors && rms == o.rms;
+    }
+
+    bool operator!=(const OverlapStats& o) const { return !(*this == o); }
+};
+
+} // namespace sparse_distributed_representation
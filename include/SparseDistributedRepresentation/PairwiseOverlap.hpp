@@ -0,0 +1,152 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "SparseDistributedRepresentation/SDR.hpp"
+#include "SparseDistributedRepresentation/SDRRange.hpp"
+#include "SparseDistributedRepresentation/Parallel.hpp"
+#include "SparseDistributedRepresentation/DataTypes/ArithData.hpp"
+
+namespace sparse_distributed_representation {
+
+// the overlap (ands) between every pair in a collection of SDRs.
+// like the n-ary ops, each function takes a range of SDRs, or pointers to SDRs, or std::reference_wrappers of SDRs.
+//
+// the matrix is symmetric, so only the tiles on or above the diagonal are computed. a tile is the pairs between
+// two blocks of SDRs, so each SDR is reused for every SDR in the other block while it is still in cache.
+// the tiles are spread over a pool of threads.
+
+namespace pairwise {
+
+// the default sparse matrix type, row major with the overlap as the data
+using overlap_matrix_type = SDR<SDRElem<int, SDR<SDRElem<int, ArithData<std::size_t>>>>>;
+
+template<typename Range>
+auto gather(const Range& sdrs) {
+    std::vector<const nary_ops::sdr_type<Range>*> ret;
+    for (const auto& sdr : sdrs) ret.push_back(&nary_ops::deref(sdr));
+    return ret;
+}
+
+/**
+ * calls visitor(i, j, overlap, worker) for each pair i <= j of the SDRs.
+ * visitor is called concurrently, with the worker in [0, workers).
+ */
+template<typename sdr_t, typename Visitor>
+void for_each_pair(const std::vector<const sdr_t*>& sdrs, unsigned workers, std::size_t tile, Visitor&& visitor) {
+    const std::size_t n = sdrs.size();
+    if (tile == 0) tile = 1;
+    const std::size_t blocks = (n + tile - 1) / tile;
+    // the first task of each block row. block row b has the tiles (b, b), (b, b + 1), ..., (b, blocks - 1)
+    std::vector<std::size_t> row_start(blocks + 1, 0);
+    for (std::size_t b = 0; b < blocks; ++b) row_start[b + 1] = row_start[b] + blocks - b;
+
+    parallel::for_each_task(row_start.back(), workers, [&](std::size_t task, unsigned worker) {
+        std::size_t bi = static_cast<std::size_t>(std::upper_bound(row_start.cbegin(), row_start.cend(), task) - row_start.cbegin()) - 1;
+        std::size_t bj = bi + (task - row_start[bi]);
+        std::size_t i_end = std::min(n, (bi + 1) * tile);
+        std::size_t j_end = std::min(n, (bj + 1) * tile);
+        for (std::size_t i = bi * tile; i < i_end; ++i) {
+            const sdr_t& a = *sdrs[i];
+            for (std::size_t j = bi == bj ? i : bj * tile; j < j_end; ++j) {
+                visitor(i, j, a.ands(*sdrs[j]), worker);
+            }
+        }
+    });
+}
+
+} // namespace pairwise
+
+/**
+ * Computes the dense overlap matrix of the SDRs.
+ *
+ * @param out has room for n * n elements, for n SDRs. out[i * n + j] is set to the overlap between SDRs i and j.
+ * @param threads the number of threads to use. 0 means one per hardware thread.
+ * @param tile the number of SDRs in each block.
+ */
+template<typename T, typename Range>
+void overlap_matrix(const Range& sdrs, T* out, unsigned threads = 0, std::size_t tile = 64) {
+    auto ptrs = pairwise::gather(sdrs);
+    const std::size_t n = ptrs.size();
+    const std::size_t tasks = tile == 0 ? n : (n + tile - 1) / tile;
+    // each tile writes to its own cells, and the cells mirrored across the diagonal
+    pairwise::for_each_pair(ptrs, parallel::worker_count(threads, tasks * (tasks + 1) / 2), tile, [&](std::size_t i, std::size_t j, std::size_t overlap, unsigned) {
+        out[i * n + j] = static_cast<T>(overlap);
+        out[j * n + i] = static_cast<T>(overlap);
+    });
+}
+
+/**
+ * Computes the sparse overlap matrix of the SDRs, which only has the pairs with at least some overlap.
+ * This includes the diagonal, where the overlap is the size of the SDR.
+ *
+ * @tparam matrix_t a row major matrix. the ids are indices in the range and the data is the overlap.
+ * @param threshold the minimum overlap of the pairs in the result. pairs with no overlap are never included.
+ * @param threads the number of threads to use. 0 means one per hardware thread.
+ * @param tile the number of SDRs in each block.
+ */
+template<typename matrix_t = pairwise::overlap_matrix_type, typename Range>
+matrix_t overlap_pairs(const Range& sdrs, std::size_t threshold, unsigned threads = 0, std::size_t tile = 64) {
+    using row_elem_t = typename matrix_t::value_type;
+    using row_t = typename row_elem_t::data_type;
+    using cell_t = typename row_t::value_type;
+    struct Pair {
+        std::size_t i;
+        std::size_t j;
+        std::size_t overlap;
+    };
+
+    auto ptrs = pairwise::gather(sdrs);
+    const std::size_t n = ptrs.size();
+    if (threshold == 0) threshold = 1;
+    const std::size_t tasks = tile == 0 ? n : (n + tile - 1) / tile;
+    const unsigned workers = parallel::worker_count(threads, tasks * (tasks + 1) / 2);
+
+    // each worker appends to its own list, so there's no locking
+    std::vector<std::vector<Pair>> found(workers);
+    pairwise::for_each_pair(ptrs, workers, tile, [&](std::size_t i, std::size_t j, std::size_t overlap, unsigned worker) {
+        if (overlap >= threshold) found[worker].push_back(Pair{i, j, overlap});
+    });
+
+    // bucket the pairs by row (counting sort), with each pair placed in both of its rows
+    std::vector<std::size_t> row_start(n + 1, 0);
+    for (const auto& pairs : found) {
+        for (const Pair& p : pairs) {
+            ++row_start[p.i + 1];
+            if (p.i != p.j) ++row_start[p.j + 1];
+        }
+    }
+    for (std::size_t i = 0; i < n; ++i) row_start[i + 1] += row_start[i];
+    std::vector<std::size_t> fill(row_start.cbegin(), row_start.cend() - 1);
+    std::vector<std::pair<std::size_t, std::size_t>> cells(row_start.back()); // column, overlap
+    for (auto& pairs : found) {
+        for (const Pair& p : pairs) {
+            cells[fill[p.i]++] = {p.j, p.overlap};
+            if (p.i != p.j) cells[fill[p.j]++] = {p.i, p.overlap};
+        }
+        std::vector<Pair>().swap(pairs);
+    }
+
+    matrix_t ret;
+    nary_ops::Appender<matrix_t> append_row(ret);
+    for (std::size_t i = 0; i < n; ++i) {
+        auto begin = cells.begin() + static_cast<std::ptrdiff_t>(row_start[i]);
+        auto end = cells.begin() + static_cast<std::ptrdiff_t>(row_start[i + 1]);
+        if (begin == end) continue;
+        // the workers found the pairs in any order
+        std::sort(begin, end);
+        row_t row = ret.template make_empty<row_t>();
+        {
+            nary_ops::Appender<row_t> append_cell(row);
+            for (auto it = begin; it != end; ++it) {
+                append_cell(cell_t(static_cast<typename cell_t::id_type>(it->first), typename cell_t::data_type(it->second)));
+            }
+        }
+        append_row(row_elem_t(static_cast<typename row_elem_t::id_type>(i), std::move(row)));
+    }
+    return ret;
+}
+
+} // namespace sparse_distributed_representation
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sparse_distributed_representation {
+
+namespace parallel {
+
+// the number of workers to use for some number of tasks. 0 threads means one per hardware thread
+inline unsigned worker_count(unsigned threads, std::size_t tasks) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    return static_cast<unsigned>(std::max<std::size_t>(1, std::min<std::size_t>(threads, tasks)));
+}
+
+/**
+ * Runs the tasks [0, tasks) on a pool of worker threads.
+ * Each worker takes the next task from a shared counter, so uneven tasks are balanced between the workers.
+ * If there is only one worker, then the tasks are run in order on the calling thread.
+ * If fewer threads can be started than there are workers, then the tasks are run on the threads that did start.
+ *
+ * @param workers from worker_count.
+ * @param fn called as fn(std::size_t task, unsigned worker). the worker is in [0, workers), and
+ *           a worker runs one task at a time, so per-worker state can be indexed by it without locking.
+ *           if fn throws, then the remaining tasks are skipped and the first exception is rethrown.
+ */
+template<typename Fn>
+void for_each_task(std::size_t tasks, unsigned workers, Fn&& fn) {
+    if (workers <= 1) {
+        for (std::size_t task = 0; task < tasks; ++task) fn(task, 0u);
+        return;
+    }
+    std::atomic<std::size_t> next(0);
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto work = [&](unsigned worker) {
+        try {
+            for (std::size_t task = next++; task < tasks; task = next++) fn(task, worker);
+        } catch (...) {
+            next = tasks;
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) error = std::current_exception();
+        }
+    };
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    try {
+        for (unsigned worker = 1; worker < workers; ++worker) pool.emplace_back(work, worker);
+    } catch (...) {
+        // a thread couldn't be started (std::system_error). the threads which did start are still joined below,
+        // and the tasks are shared between them and the calling thread, so every task still runs
+    }
+    work(0); // the calling thread is a worker as well
+    for (auto& t : pool) t.join();
+    if (error) std::rethrow_exception(error);
+}
+
+} // namespace parallel
+
+} // namespace sparse_distributed_representation
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "SparseDistributedRepresentation/SDR.hpp"
+#include "SparseDistributedRepresentation/SDRRange.hpp"
+#include "SparseDistributedRepresentation/Parallel.hpp"
+
+namespace sparse_distributed_representation {
+
+// multithreaded variants of the matrix ops, for matrices stored as an SDR of rows.
+// each output row only depends on one row of the input, so the rows are split into blocks which are spread over a pool of threads.
+// each block is computed into its own buffer, and the buffers are appended to the result in row order once every block is done.
+//
+// the results are the same as the single threaded ops. if the containers have allocators, then the rows are made with the
+// input's allocator from every thread, so it must be thread safe (e.g. std::pmr::synchronized_pool_resource).
+
+namespace parallel {
+
+struct NoState {};
+
+/**
+ * calls fn(row, out, state) for each row of the matrix, where out is a std::vector of output rows to append to.
+ * the output rows are then appended to ret in the order of the input rows.
+ *
+ * @tparam state_t default constructed once per worker, and passed to each call on that worker (e.g. scratch space).
+ */
+template<typename state_t = NoState, typename ret_sdr_t, typename matrix_t, typename Fn>
+ret_sdr_t map_rows(const matrix_t& matrix, ret_sdr_t ret, unsigned threads, Fn&& fn) {
+    std::vector<const typename matrix_t::value_type*> rows;
+    rows.reserve(matrix.size());
+    for (const auto& row : matrix) rows.push_back(&row);
+
+    unsigned workers = worker_count(threads, rows.size());
+    // a few blocks per worker, so uneven rows are balanced between the workers
+    std::size_t blocks = std::min<std::size_t>(rows.size(), static_cast<std::size_t>(workers) * 8);
+    std::vector<std::vector<typename ret_sdr_t::value_type>> outputs(blocks);
+    std::vector<state_t> states(workers);
+    for_each_task(blocks, workers, [&](std::size_t block, unsigned worker) {
+        std::size_t begin = rows.size() * block / blocks;
+        std::size_t end = rows.size() * (block + 1) / blocks;
+        for (std::size_t i = begin; i < end; ++i) fn(*rows[i], outputs[block], states[worker]);
+    });
+
+    if constexpr(matrix_utils::reservable<typename ret_sdr_t::container_type>::value) {
+        std::size_t total = 0;
+        for (const auto& output : outputs) total += output.size();
+        ret.reserve(static_cast<typename ret_sdr_t::size_type>(total));
+    }
+    nary_ops::Appender<ret_sdr_t> append(ret);
+    for (auto& output : outputs) {
+        for (auto& row : output) append(std::move(row));
+    }
+    return ret;
+}
+
+// multiplies the matrix (row major) with the vector. see SDR::row_major_mul_vec
+template<typename SDRElem_t,
+        typename container_t,
+        typename arg_t,
+        typename c_arg_t,
+        typename ret_t = arg_t,
+        typename c_ret_t = c_arg_t>
+SDR<ret_t, c_ret_t> row_major_mul_vec(const SDR<SDRElem_t, container_t>& matrix, const SDR<arg_t, c_arg_t>& arg, unsigned threads = 0) {
+    using ret_sdr_t = SDR<ret_t, c_ret_t>;
+    return map_rows(matrix, matrix.template make_empty<ret_sdr_t>(), threads, [&](const SDRElem_t& row, std::vector<ret_t>& out, NoState&) {
+        auto data = row.data().template inner<typename ret_t::data_type>(arg);
+        if (data.relevant()) out.emplace_back(row.id(), std::move(data));
+    });
+}
+
+/**
+ * multiplies two matrices with the same row/column major format. see SDR::same_mul
+ * each output row is computed with Gustavson's method, and each worker has its own accumulator.
+ *
+ * @tparam accumulator_t a matrix_utils::HashAccumulator or matrix_utils::DenseAccumulator of the output row's elements.
+ *                       the dense accumulator is faster, but needs non-negative column ids in a compact range.
+ */
+template<typename SDRElem_t,
+        typename container_t,
+        typename arg_t,
+        typename c_arg_t,
+        typename ret_t = arg_t,
+        typename c_ret_t = c_arg_t,
+        typename accumulator_t = matrix_utils::HashAccumulator<typename ret_t::data_type::value_type>>
+SDR<ret_t, c_ret_t> same_mul(const SDR<SDRElem_t, container_t>& matrix, const SDR<arg_t, c_arg_t>& arg, unsigned threads = 0) {
+    using ret_sdr_t = SDR<ret_t, c_ret_t>;
+    using multiply_t = matrix_utils::GustavsonRow<accumulator_t, typename SDRElem_t::data_type::value_type, arg_t>;
+    return map_rows<multiply_t>(matrix, matrix.template make_empty<ret_sdr_t>(), threads, [&](const SDRElem_t& row, std::vector<ret_t>& out, multiply_t& multiply) {
+        typename ret_t::data_type data = matrix.template make_empty<typename ret_t::data_type>();
+        multiply(row.data(), arg, data);
+        if (data.relevant()) out.emplace_back(row.id(), std::move(data));
+    });
+}
+
+/**
+ * multiplies two matrices with different row/column major formats. see SDR::diff_mul
+ * the returned matrix has the same row/column format as the first matrix.
+ */
+template<typename SDRElem_t,
+        typename container_t,
+        typename arg_t,
+        typename c_arg_t,
+        typename ret_t = arg_t,
+        typename c_ret_t = c_arg_t>
+SDR<ret_t, c_ret_t> diff_mul(const SDR<SDRElem_t, container_t>& matrix, const SDR<arg_t, c_arg_t>& arg, unsigned threads = 0) {
+    using ret_sdr_t = SDR<ret_t, c_ret_t>;
+    return map_rows(matrix, matrix.template make_empty<ret_sdr_t>(), threads, [&](const SDRElem_t& row, std::vector<ret_t>& out, NoState&) {
+        typename ret_t::data_type data = matrix.template make_empty<typename ret_t::data_type>();
+        nary_ops::Appender<typename ret_t::data_type> append(data);
+        for (const auto& column : arg) {
+            auto elem_data = row.data().template inner<typename ret_t::data_type::value_type::data_type>(column.data());
+            if (elem_data.relevant()) append(typename ret_t::data_type::value_type(column.id(), std::move(elem_data)));
+        }
+        if (data.relevant()) out.emplace_back(row.id(), std::move(data));
+    });
+}
+
+// outer product. each element of the SDR is a row of the output. see SDR::outer
+template<typename SDRElem_t,
+        typename container_t,
+        typename arg_t,
+        typename c_arg_t,
+        typename ret_t = SDRElem<typename SDRElem_t::id_type, SDR<arg_t, c_arg_t>>,
+        typename c_ret_t = replace_value_type<container_t, ret_t>>
+SDR<ret_t, c_ret_t> outer(const SDR<SDRElem_t, container_t>& sdr, const SDR<arg_t, c_arg_t>& other, unsigned threads = 0) {
+    using ret_sdr_t = SDR<ret_t, c_ret_t>;
+    return map_rows(sdr, sdr.template make_empty<ret_sdr_t>(), threads, [&](const SDRElem_t& elem, std::vector<ret_t>& out, NoState&) {
+        typename ret_t::data_type data = sdr.template make_empty<typename ret_t::data_type>();
+        if constexpr(matrix_utils::reservable<typename ret_t::data_type::container_type>::value) {
+            data.reserve(other.size());
+        }
+        nary_ops::Appender<typename ret_t::data_type> append(data);
+        for (const auto& other_elem : other) {
+            auto val_data = elem.data().template ande<typename ret_t::data_type::value_type::data_type>(other_elem.data());
+            append(typename ret_t::data_type::value_type(other_elem.id(), std::move(val_data)));
+        }
+        out.emplace_back(elem.id(), std::move(data));
+    });
+}
+
+} // namespace parallel
+
+} // namespace sparse_distributed_representation
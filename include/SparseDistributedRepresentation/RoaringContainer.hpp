@@ -0,0 +1,871 @@
+#pragma once
+
+#include <algorithm>
+#include <assert.h>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include "SparseDistributedRepresentation/SDRElem.hpp"
+
+namespace sparse_distributed_representation {
+
+namespace roaring_container_objs {
+
+enum class ChunkKind : unsigned char { array, bitmap, run };
+
+// a position within a chunk.
+// slot is the index in the array (array chunk) or the index of the run (run chunk). it isn't used by bitmap chunks
+struct Pos {
+    std::uint32_t slot;
+    std::uint32_t low;
+};
+
+// the elements which share the same high 16 bits. only the low 16 bits are stored
+struct Chunk {
+    // past this many elements, a bitmap is smaller than an array
+    static constexpr std::uint32_t max_array = 4096;
+    static constexpr std::size_t bitmap_words = (1 << 16) / 64;
+    // a low past the end of the chunk
+    static constexpr std::uint32_t none = 1 << 16;
+
+    explicit Chunk(std::uint16_t key) : key(key), kind(ChunkKind::array), card(0) {}
+
+    std::uint16_t key;
+    ChunkKind kind;
+    std::uint32_t card;
+    // array: the sorted lows.
+    // run: flattened [start, last] pairs, sorted and not touching
+    std::vector<std::uint16_t> vals;
+    // bitmap: a bit for each low
+    std::vector<std::uint64_t> bits;
+
+    std::uint32_t runs() const { return static_cast<std::uint32_t>(vals.size() / 2); }
+    std::uint32_t start(std::uint32_t r) const { return vals[2 * r]; }
+    std::uint32_t last(std::uint32_t r) const { return vals[2 * r + 1]; }
+
+    bool test(std::uint32_t low) const { return (bits[low / 64] >> (low % 64)) & 1; }
+
+    // the first set bit at or after low, or none
+    std::uint32_t next_set(std::uint32_t low) const {
+        if (low >= none) return none;
+        std::size_t w = low / 64;
+        std::uint64_t word = bits[w] & (~std::uint64_t(0) << (low % 64));
+        while (true) {
+            if (word) return static_cast<std::uint32_t>(w * 64 + __builtin_ctzll(word));
+            if (++w == bitmap_words) return none;
+            word = bits[w];
+        }
+    }
+
+    // the last set bit before low, or none
+    std::uint32_t prev_set(std::uint32_t low) const {
+        if (low == 0) return none;
+        --low;
+        std::size_t w = low / 64;
+        unsigned shift = 63 - low % 64;
+        std::uint64_t word = (bits[w] << shift) >> shift;
+        while (true) {
+            if (word) return static_cast<std::uint32_t>(w * 64 + 63 - __builtin_clzll(word));
+            if (w == 0) return none;
+            word = bits[--w];
+        }
+    }
+
+    // the index of the first run which ends at or after low
+    std::uint32_t run_lower_bound(std::uint32_t low) const {
+        std::uint32_t lo = 0;
+        std::uint32_t hi = runs();
+        while (lo < hi) {
+            std::uint32_t mid = lo + (hi - lo) / 2;
+            if (last(mid) < low) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    // the chunk must not be empty
+    Pos first() const {
+        if (kind == ChunkKind::bitmap) return {0, next_set(0)};
+        return {0, vals.front()};
+    }
+
+    // the chunk must not be empty
+    Pos last_pos() const {
+        switch (kind) {
+            case ChunkKind::array: return {card - 1, vals.back()};
+            case ChunkKind::bitmap: return {0, prev_set(none)};
+            default: return {runs() - 1, vals.back()};
+        }
+    }
+
+    // false if the position no longer refers to an element in this chunk (e.g. after an erase)
+    bool valid(Pos p) const {
+        switch (kind) {
+            case ChunkKind::array: return p.slot < vals.size() && vals[p.slot] == p.low;
+            case ChunkKind::bitmap: return true;
+            default: return p.slot < runs() && start(p.slot) <= p.low && p.low <= last(p.slot);
+        }
+    }
+
+    // false if there isn't a next element in this chunk
+    bool next(Pos& p) const {
+        switch (kind) {
+            case ChunkKind::array:
+                if (++p.slot == vals.size()) return false;
+                p.low = vals[p.slot];
+                return true;
+            case ChunkKind::bitmap:
+                p.low = next_set(p.low + 1);
+                return p.low != none;
+            default:
+                if (p.low < last(p.slot)) {
+                    ++p.low;
+                    return true;
+                }
+                if (++p.slot == runs()) return false;
+                p.low = start(p.slot);
+                return true;
+        }
+    }
+
+    // false if there isn't a previous element in this chunk. p is unchanged in that case
+    bool prev(Pos& p) const {
+        switch (kind) {
+            case ChunkKind::array:
+                if (p.slot == 0) return false;
+                p.low = vals[--p.slot];
+                return true;
+            case ChunkKind::bitmap: {
+                std::uint32_t low = prev_set(p.low);
+                if (low == none) return false;
+                p.low = low;
+                return true;
+            }
+            default:
+                if (p.low > start(p.slot)) {
+                    --p.low;
+                    return true;
+                }
+                if (p.slot == 0) return false;
+                p.low = last(--p.slot);
+                return true;
+        }
+    }
+
+    // the first element at or after low. false if there isn't one
+    bool lower_bound(std::uint32_t low, Pos& p) const {
+        switch (kind) {
+            case ChunkKind::array: {
+                auto it = std::lower_bound(vals.begin(), vals.end(), low);
+                if (it == vals.end()) return false;
+                p = {static_cast<std::uint32_t>(it - vals.begin()), *it};
+                return true;
+            }
+            case ChunkKind::bitmap:
+                p = {0, next_set(low)};
+                return p.low != none;
+            default: {
+                std::uint32_t r = run_lower_bound(low);
+                if (r == runs()) return false;
+                p = {r, std::max(low, start(r))};
+                return true;
+            }
+        }
+    }
+
+    // calls f(low) for each element, in ascending order
+    template<typename F>
+    void for_each(F f) const {
+        switch (kind) {
+            case ChunkKind::array:
+                for (auto low : vals) f(static_cast<std::uint32_t>(low));
+                break;
+            case ChunkKind::bitmap:
+                for (std::size_t w = 0; w < bitmap_words; ++w) {
+                    std::uint64_t word = bits[w];
+                    while (word) {
+                        f(static_cast<std::uint32_t>(w * 64 + __builtin_ctzll(word)));
+                        word &= word - 1;
+                    }
+                }
+                break;
+            default:
+                for (std::uint32_t r = 0; r < runs(); ++r) {
+                    for (std::uint32_t low = start(r); low <= last(r); ++low) f(low);
+                }
+                break;
+        }
+    }
+
+    // false if the element is already in the chunk. p is set to the position of the element
+    bool insert(std::uint16_t low, Pos& p) {
+        switch (kind) {
+            case ChunkKind::array: {
+                auto it = vals.end();
+                if (!vals.empty() && vals.back() >= low) {
+                    it = std::lower_bound(vals.begin(), vals.end(), low);
+                }
+                p = {static_cast<std::uint32_t>(it - vals.begin()), low};
+                if (it != vals.end() && *it == low) return false;
+                vals.insert(it, low);
+                if (++card > max_array) {
+                    to_bitmap();
+                    p.slot = 0;
+                }
+                return true;
+            }
+            case ChunkKind::bitmap: {
+                p = {0, low};
+                std::uint64_t& word = bits[low / 64];
+                std::uint64_t bit = std::uint64_t(1) << (low % 64);
+                if (word & bit) return false;
+                word |= bit;
+                ++card;
+                return true;
+            }
+            default: {
+                std::uint32_t r = run_lower_bound(low);
+                if (r < runs() && start(r) <= low) {
+                    p = {r, low};
+                    return false;
+                }
+                ++card;
+                bool join_prev = r > 0 && last(r - 1) + 1 == low;
+                bool join_next = r < runs() && start(r) == low + 1u;
+                if (join_prev && join_next) {
+                    vals[2 * (r - 1) + 1] = vals[2 * r + 1];
+                    vals.erase(vals.begin() + 2 * r, vals.begin() + 2 * r + 2);
+                    p = {r - 1, low};
+                } else if (join_prev) {
+                    vals[2 * (r - 1) + 1] = low;
+                    p = {r - 1, low};
+                } else if (join_next) {
+                    vals[2 * r] = low;
+                    p = {r, low};
+                } else {
+                    vals.insert(vals.begin() + 2 * r, {low, low});
+                    p = {r, low};
+                }
+                return true;
+            }
+        }
+    }
+
+    // false if the element isn't in the chunk
+    bool erase(std::uint16_t low) {
+        switch (kind) {
+            case ChunkKind::array: {
+                auto it = std::lower_bound(vals.begin(), vals.end(), low);
+                if (it == vals.end() || *it != low) return false;
+                vals.erase(it);
+                --card;
+                return true;
+            }
+            case ChunkKind::bitmap: {
+                std::uint64_t& word = bits[low / 64];
+                std::uint64_t bit = std::uint64_t(1) << (low % 64);
+                if (!(word & bit)) return false;
+                word &= ~bit;
+                if (--card <= max_array) to_array();
+                return true;
+            }
+            default: {
+                std::uint32_t r = run_lower_bound(low);
+                if (r == runs() || start(r) > low) return false;
+                --card;
+                std::uint16_t s = vals[2 * r];
+                std::uint16_t l = vals[2 * r + 1];
+                if (s == l) {
+                    vals.erase(vals.begin() + 2 * r, vals.begin() + 2 * r + 2);
+                } else if (low == s) {
+                    ++vals[2 * r];
+                } else if (low == l) {
+                    --vals[2 * r + 1];
+                } else {
+                    vals[2 * r + 1] = low - 1;
+                    vals.insert(vals.begin() + 2 * r + 2, {static_cast<std::uint16_t>(low + 1), l});
+                }
+                return true;
+            }
+        }
+    }
+
+    void to_array() {
+        if (kind == ChunkKind::array) return;
+        std::vector<std::uint16_t> a;
+        a.reserve(card);
+        for_each([&](std::uint32_t low) { a.push_back(static_cast<std::uint16_t>(low)); });
+        vals = std::move(a);
+        bits = std::vector<std::uint64_t>();
+        kind = ChunkKind::array;
+    }
+
+    void to_bitmap() {
+        if (kind == ChunkKind::bitmap) return;
+        std::vector<std::uint64_t> b(bitmap_words);
+        for_each([&](std::uint32_t low) { b[low / 64] |= std::uint64_t(1) << (low % 64); });
+        bits = std::move(b);
+        vals = std::vector<std::uint16_t>();
+        kind = ChunkKind::bitmap;
+    }
+
+    void to_run() {
+        if (kind == ChunkKind::run) return;
+        std::vector<std::uint16_t> r;
+        for_each([&](std::uint32_t low) {
+            if (!r.empty() && r.back() + 1u == low) {
+                r.back() = static_cast<std::uint16_t>(low);
+            } else {
+                r.push_back(static_cast<std::uint16_t>(low));
+                r.push_back(static_cast<std::uint16_t>(low));
+            }
+        });
+        vals = std::move(r);
+        bits = std::vector<std::uint64_t>();
+        kind = ChunkKind::run;
+    }
+
+    std::uint32_t count_runs() const {
+        switch (kind) {
+            case ChunkKind::array: {
+                std::uint32_t r = 0;
+                for (std::size_t i = 0; i < vals.size(); ++i) {
+                    if (i == 0 || vals[i - 1] + 1u != vals[i]) ++r;
+                }
+                return r;
+            }
+            case ChunkKind::bitmap: {
+                // a run starts at each set bit whose lower neighbour is not set
+                std::uint32_t r = 0;
+                std::uint64_t carry = 0;
+                for (std::size_t w = 0; w < bitmap_words; ++w) {
+                    r += __builtin_popcountll(bits[w] & ~((bits[w] << 1) | carry));
+                    carry = bits[w] >> 63;
+                }
+                return r;
+            }
+            default: return runs();
+        }
+    }
+
+    // change to whichever kind uses the least memory
+    void optimize() {
+        std::size_t run_bytes = count_runs() * 2 * sizeof(std::uint16_t);
+        std::size_t array_bytes = card * sizeof(std::uint16_t);
+        std::size_t bitmap_bytes = bitmap_words * sizeof(std::uint64_t);
+        if (run_bytes < std::min(array_bytes, bitmap_bytes)) {
+            to_run();
+        } else if (card <= max_array) {
+            to_array();
+        } else {
+            to_bitmap();
+        }
+        vals.shrink_to_fit();
+    }
+
+    std::size_t memory_usage() const {
+        return vals.capacity() * sizeof(std::uint16_t) + bits.capacity() * sizeof(std::uint64_t);
+    }
+};
+
+// the number of set bits in [first, last]
+inline std::uint32_t bitmap_range_count(const Chunk& c, std::uint32_t first, std::uint32_t last) {
+    std::size_t w_first = first / 64;
+    std::size_t w_last = last / 64;
+    std::uint64_t first_mask = ~std::uint64_t(0) << (first % 64);
+    std::uint64_t last_mask = ~std::uint64_t(0) >> (63 - last % 64);
+    if (w_first == w_last) return __builtin_popcountll(c.bits[w_first] & first_mask & last_mask);
+    std::uint32_t r = __builtin_popcountll(c.bits[w_first] & first_mask);
+    for (std::size_t w = w_first + 1; w < w_last; ++w) r += __builtin_popcountll(c.bits[w]);
+    return r + __builtin_popcountll(c.bits[w_last] & last_mask);
+}
+
+// calls visitor(a_pos, b_pos) for each element in both a and b, in ascending order
+template<typename Visitor>
+void and_chunks(const Chunk& a, const Chunk& b, Visitor visitor) {
+    if (a.kind == ChunkKind::run || b.kind == ChunkKind::run) {
+        // walk the other chunk within each run
+        bool a_runs = a.kind == ChunkKind::run;
+        const Chunk& runs = a_runs ? a : b;
+        const Chunk& other = a_runs ? b : a;
+        for (std::uint32_t r = 0; r < runs.runs(); ++r) {
+            Pos p;
+            if (!other.lower_bound(runs.start(r), p)) return;
+            while (p.low <= runs.last(r)) {
+                Pos run_pos{r, p.low};
+                if (a_runs) {
+                    visitor(run_pos, p);
+                } else {
+                    visitor(p, run_pos);
+                }
+                if (!other.next(p)) return;
+            }
+        }
+    } else if (a.kind == ChunkKind::bitmap && b.kind == ChunkKind::bitmap) {
+        for (std::size_t w = 0; w < Chunk::bitmap_words; ++w) {
+            std::uint64_t word = a.bits[w] & b.bits[w];
+            while (word) {
+                auto low = static_cast<std::uint32_t>(w * 64 + __builtin_ctzll(word));
+                visitor(Pos{0, low}, Pos{0, low});
+                word &= word - 1;
+            }
+        }
+    } else if (a.kind == ChunkKind::bitmap) {
+        for (std::uint32_t j = 0; j < b.card; ++j) {
+            std::uint32_t low = b.vals[j];
+            if (a.test(low)) visitor(Pos{0, low}, Pos{j, low});
+        }
+    } else if (b.kind == ChunkKind::bitmap) {
+        for (std::uint32_t i = 0; i < a.card; ++i) {
+            std::uint32_t low = a.vals[i];
+            if (b.test(low)) visitor(Pos{i, low}, Pos{0, low});
+        }
+    } else {
+        // both arrays. same as the vector case in SDR::andv
+        std::uint32_t i = 0;
+        std::uint32_t j = 0;
+        if (a.card * 8 < b.card) {
+            for (; i < a.card; ++i) {
+                j = static_cast<std::uint32_t>(std::lower_bound(b.vals.begin() + j, b.vals.end(), a.vals[i]) - b.vals.begin());
+                if (j == b.card) return;
+                if (b.vals[j] == a.vals[i]) visitor(Pos{i, a.vals[i]}, Pos{j, b.vals[j]});
+            }
+        } else if (b.card * 8 < a.card) {
+            for (; j < b.card; ++j) {
+                i = static_cast<std::uint32_t>(std::lower_bound(a.vals.begin() + i, a.vals.end(), b.vals[j]) - a.vals.begin());
+                if (i == a.card) return;
+                if (a.vals[i] == b.vals[j]) visitor(Pos{i, a.vals[i]}, Pos{j, b.vals[j]});
+            }
+        } else {
+            while (i < a.card && j < b.card) {
+                if (a.vals[i] < b.vals[j]) {
+                    ++i;
+                } else if (a.vals[i] > b.vals[j]) {
+                    ++j;
+                } else {
+                    visitor(Pos{i, a.vals[i]}, Pos{j, b.vals[j]});
+                    ++i;
+                    ++j;
+                }
+            }
+        }
+    }
+}
+
+// the number of elements in both a and b
+inline std::uint32_t and_chunks_count(const Chunk& a, const Chunk& b) {
+    if (a.kind == ChunkKind::bitmap && b.kind == ChunkKind::bitmap) {
+        std::uint32_t r = 0;
+        for (std::size_t w = 0; w < Chunk::bitmap_words; ++w) r += __builtin_popcountll(a.bits[w] & b.bits[w]);
+        return r;
+    }
+    if (a.kind == ChunkKind::run && b.kind == ChunkKind::run) {
+        // overlap of intervals
+        std::uint32_t r = 0;
+        std::uint32_t i = 0;
+        std::uint32_t j = 0;
+        while (i < a.runs() && j < b.runs()) {
+            std::uint32_t lo = std::max(a.start(i), b.start(j));
+            std::uint32_t hi = std::min(a.last(i), b.last(j));
+            if (lo <= hi) r += hi - lo + 1;
+            if (a.last(i) < b.last(j)) {
+                ++i;
+            } else {
+                ++j;
+            }
+        }
+        return r;
+    }
+    if (a.kind == ChunkKind::run || b.kind == ChunkKind::run) {
+        const Chunk& runs = a.kind == ChunkKind::run ? a : b;
+        const Chunk& other = a.kind == ChunkKind::run ? b : a;
+        std::uint32_t r = 0;
+        if (other.kind == ChunkKind::bitmap) {
+            for (std::uint32_t k = 0; k < runs.runs(); ++k) r += bitmap_range_count(other, runs.start(k), runs.last(k));
+        } else {
+            auto pos = other.vals.begin();
+            for (std::uint32_t k = 0; k < runs.runs(); ++k) {
+                pos = std::lower_bound(pos, other.vals.end(), runs.start(k));
+                auto end = std::upper_bound(pos, other.vals.end(), runs.last(k));
+                r += static_cast<std::uint32_t>(end - pos);
+                pos = end;
+            }
+        }
+        return r;
+    }
+    std::uint32_t r = 0;
+    and_chunks(a, b, [&](Pos, Pos) { ++r; });
+    return r;
+}
+
+// calls a_visitor(a_pos), b_visitor(b_pos), or both_visitor(a_pos, b_pos) for each element in a or b, in ascending order
+template<typename AVisitor, typename BVisitor, typename BothVisitor>
+void or_chunks(const Chunk& a, const Chunk& b, AVisitor a_visitor, BVisitor b_visitor, BothVisitor both_visitor) {
+    if (a.kind == ChunkKind::bitmap && b.kind == ChunkKind::bitmap) {
+        for (std::size_t w = 0; w < Chunk::bitmap_words; ++w) {
+            std::uint64_t word = a.bits[w] | b.bits[w];
+            while (word) {
+                unsigned bit = __builtin_ctzll(word);
+                auto low = static_cast<std::uint32_t>(w * 64 + bit);
+                bool in_a = (a.bits[w] >> bit) & 1;
+                bool in_b = (b.bits[w] >> bit) & 1;
+                if (in_a && in_b) {
+                    both_visitor(Pos{0, low}, Pos{0, low});
+                } else if (in_a) {
+                    a_visitor(Pos{0, low});
+                } else {
+                    b_visitor(Pos{0, low});
+                }
+                word &= word - 1;
+            }
+        }
+        return;
+    }
+    Pos pa = a.first();
+    Pos pb = b.first();
+    bool has_a = true;
+    bool has_b = true;
+    while (has_a && has_b) {
+        if (pa.low < pb.low) {
+            a_visitor(pa);
+            has_a = a.next(pa);
+        } else if (pa.low > pb.low) {
+            b_visitor(pb);
+            has_b = b.next(pb);
+        } else {
+            both_visitor(pa, pb);
+            has_a = a.next(pa);
+            has_b = b.next(pb);
+        }
+    }
+    while (has_a) {
+        a_visitor(pa);
+        has_a = a.next(pa);
+    }
+    while (has_b) {
+        b_visitor(pb);
+        has_b = b.next(pb);
+    }
+}
+
+// the chunks don't store elements (only the low bits of the ids), so the iterator dereferences to an element by value.
+// a position which no longer refers to its element (from an insert or erase elsewhere in the chunk) is looked up again by id
+template<typename container_t>
+class ConstIterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = typename container_t::value_type;
+        using reference = value_type;
+        using pointer = const value_type*;
+
+        static constexpr std::size_t end_index = static_cast<std::size_t>(-1);
+
+        ConstIterator() : container(nullptr), chunk_index(end_index), pos{0, 0}, elem() {}
+
+        ConstIterator(const container_t* container, std::size_t chunk_index, Pos pos)
+            : container(container), chunk_index(chunk_index), pos(pos), elem() {
+            if (chunk_index != end_index) {
+                elem = value_type(container_t::from_u(container->chunks()[chunk_index].key * 0x10000u + pos.low));
+            }
+        }
+
+        reference operator*() const { return elem; }
+        pointer operator->() const { return &elem; }
+
+        ConstIterator& operator++() {
+            assert(chunk_index != end_index);
+            if (!valid()) {
+                // the chunk was changed since this was made
+                std::uint64_t next = std::uint64_t(container_t::to_u(elem.id())) + 1;
+                *this = container->lower_bound_u(next);
+                return *this;
+            }
+            const auto& chunks = container->chunks();
+            if (!chunks[chunk_index].next(pos)) {
+                if (++chunk_index == chunks.size()) {
+                    *this = container->end();
+                    return *this;
+                }
+                pos = chunks[chunk_index].first();
+            }
+            *this = ConstIterator(container, chunk_index, pos);
+            return *this;
+        }
+
+        ConstIterator operator++(int) { ConstIterator tmp = *this; ++(*this); return tmp; }
+
+        ConstIterator& operator--() {
+            const auto& chunks = container->chunks();
+            if (chunk_index == end_index) {
+                assert(!chunks.empty());
+                *this = ConstIterator(container, chunks.size() - 1, chunks.back().last_pos());
+                return *this;
+            }
+            if (!valid()) {
+                *this = container->lower_bound_u(container_t::to_u(elem.id()));
+                return --(*this);
+            }
+            if (!chunks[chunk_index].prev(pos)) {
+                assert(chunk_index != 0);
+                --chunk_index;
+                pos = chunks[chunk_index].last_pos();
+            }
+            *this = ConstIterator(container, chunk_index, pos);
+            return *this;
+        }
+
+        ConstIterator operator--(int) { ConstIterator tmp = *this; --(*this); return tmp; }
+
+        bool operator==(const ConstIterator& o) const {
+            if (chunk_index == end_index || o.chunk_index == end_index) return chunk_index == o.chunk_index;
+            return elem.id() == o.elem.id();
+        }
+
+        bool operator!=(const ConstIterator& o) const { return !(*this == o); }
+
+    private:
+        bool valid() const {
+            const auto& chunks = container->chunks();
+            return chunk_index < chunks.size()
+                && chunks[chunk_index].key == container_t::to_u(elem.id()) >> 16
+                && chunks[chunk_index].valid(pos);
+        }
+
+        const container_t* container;
+        std::size_t chunk_index;
+        Pos pos;
+        value_type elem;
+};
+
+} // namespace roaring_container_objs
+
+// partitions the ids by their high 16 bits into chunks, like a roaring bitmap.
+// each chunk is stored as whichever of a sorted array, a bitmap, or a list of runs suits the density of that chunk,
+// so memory and op time depend on local density instead of the worst case.
+// if both operands of an andv / orv are RoaringContainers, then the chunks are combined against each other directly.
+//
+// inserting and erasing switch chunks between arrays and bitmaps as needed. runs are only made by optimize().
+//
+// it behaves like a std::set (it can lower_bound, and insert and erase anywhere).
+// iterators are not invalidated by insert or erase, except for the erased element.
+//
+// Only the necessary functions have been implemented (for use in SDR).
+template<typename SDRElem_t>
+class RoaringContainer {
+    using id_type = typename SDRElem_t::id_type;
+    static_assert(std::is_integral_v<id_type> && sizeof(id_type) <= sizeof(std::uint32_t), "RoaringContainer ids must be integers of at most 32 bits");
+    static_assert(std::is_same_v<typename SDRElem_t::data_type, EmptyData>, "RoaringContainer can't store data");
+
+    public:
+        using Chunk = roaring_container_objs::Chunk;
+        using Pos = roaring_container_objs::Pos;
+
+        using size_type = std::size_t;
+        using value_type = SDRElem_t;
+        using const_iterator = roaring_container_objs::ConstIterator<RoaringContainer>;
+        using iterator = const_iterator;
+        using reference = SDRElem_t;
+        using const_reference = SDRElem_t;
+        using pointer = const SDRElem_t*;
+        using const_pointer = const SDRElem_t*;
+
+        RoaringContainer() : count(0) {}
+
+        size_type size() const { return count; }
+        bool empty() const { return count == 0; }
+
+        const_iterator begin() const { return chunks_.empty() ? end() : const_iterator(this, 0, chunks_.front().first()); }
+        const_iterator end() const { return const_iterator(this, const_iterator::end_index, Pos{0, 0}); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+
+        const_iterator lower_bound(id_type id) const { return lower_bound_u(to_u(id)); }
+        const_iterator lower_bound(const SDRElem_t& elem) const { return lower_bound(elem.id()); }
+        const_iterator upper_bound(id_type id) const { return lower_bound_u(std::uint64_t(to_u(id)) + 1); }
+        const_iterator upper_bound(const SDRElem_t& elem) const { return upper_bound(elem.id()); }
+
+        // the first element whose unsigned id is at or after u
+        const_iterator lower_bound_u(std::uint64_t u) const {
+            if (u > UINT32_MAX) return end();
+            auto key = static_cast<std::uint16_t>(u >> 16);
+            std::size_t ci = chunk_lower_bound(key);
+            if (ci == chunks_.size()) return end();
+            if (chunks_[ci].key == key) {
+                Pos p;
+                if (chunks_[ci].lower_bound(static_cast<std::uint32_t>(u & 0xFFFF), p)) return const_iterator(this, ci, p);
+                if (++ci == chunks_.size()) return end();
+            }
+            return const_iterator(this, ci, chunks_[ci].first());
+        }
+
+        const_iterator insert(const SDRElem_t& elem) {
+            std::uint32_t u = to_u(elem.id());
+            auto key = static_cast<std::uint16_t>(u >> 16);
+            std::size_t ci;
+            if (chunks_.empty() || chunks_.back().key < key) {
+                // appending is the common case
+                ci = chunks_.size();
+                chunks_.emplace_back(key);
+            } else if (chunks_.back().key == key) {
+                ci = chunks_.size() - 1;
+            } else {
+                ci = chunk_lower_bound(key);
+                if (chunks_[ci].key != key) chunks_.emplace(chunks_.begin() + ci, key);
+            }
+            Pos p;
+            if (chunks_[ci].insert(static_cast<std::uint16_t>(u & 0xFFFF), p)) ++count;
+            return const_iterator(this, ci, p);
+        }
+
+        // the position is only a hint, same as std::set
+        const_iterator insert(const_iterator, const SDRElem_t& elem) { return insert(elem); }
+
+        const_iterator erase(const_iterator pos) {
+            std::uint32_t u = to_u(pos->id());
+            std::size_t ci = chunk_lower_bound(static_cast<std::uint16_t>(u >> 16));
+            assert(ci < chunks_.size() && chunks_[ci].key == u >> 16);
+            if (chunks_[ci].erase(static_cast<std::uint16_t>(u & 0xFFFF))) {
+                --count;
+                if (chunks_[ci].card == 0) chunks_.erase(chunks_.begin() + ci);
+            }
+            return lower_bound_u(std::uint64_t(u) + 1);
+        }
+
+        const_iterator erase(const_iterator first, const_iterator last) {
+            while (first != last) {
+                first = erase(first);
+            }
+            return first;
+        }
+
+        void clear() {
+            chunks_.clear();
+            count = 0;
+        }
+
+        // changes each chunk to the kind which uses the least memory (including runs)
+        void optimize() {
+            for (auto& chunk : chunks_) chunk.optimize();
+            chunks_.shrink_to_fit();
+        }
+
+        // approximate number of bytes used
+        std::size_t memory_usage() const {
+            std::size_t r = sizeof(*this) + chunks_.capacity() * sizeof(Chunk);
+            for (const auto& chunk : chunks_) r += chunk.memory_usage();
+            return r;
+        }
+
+        const std::vector<Chunk>& chunks() const { return chunks_; }
+
+        /**
+         * calls visitor(const_iterator, other_t::const_iterator) for each element in both this and o, in ascending order.
+         * the visitor must not insert or erase elements.
+         */
+        template<typename other_t, typename Visitor>
+        void and_visit(const other_t& o, Visitor visitor) const {
+            std::size_t i = 0;
+            std::size_t j = 0;
+            while (i < chunks_.size() && j < o.chunks().size()) {
+                if (chunks_[i].key < o.chunks()[j].key) {
+                    ++i;
+                } else if (chunks_[i].key > o.chunks()[j].key) {
+                    ++j;
+                } else {
+                    roaring_container_objs::and_chunks(chunks_[i], o.chunks()[j], [&](Pos a, Pos b) {
+                        visitor(const_iterator(this, i, a), typename other_t::const_iterator(&o, j, b));
+                    });
+                    ++i;
+                    ++j;
+                }
+            }
+        }
+
+        /**
+         * calls this_visitor(const_iterator), arg_visitor(other_t::const_iterator), or both_visitor(const_iterator, other_t::const_iterator)
+         * for each element in this or o, in ascending order.
+         * the visitors must not insert or erase elements.
+         */
+        template<typename other_t, typename ThisVisitor, typename ArgVisitor, typename BothVisitor>
+        void or_visit(const other_t& o, ThisVisitor this_visitor, ArgVisitor arg_visitor, BothVisitor both_visitor) const {
+            using other_iterator = typename other_t::const_iterator;
+            std::size_t i = 0;
+            std::size_t j = 0;
+            auto visit_this = [&](Pos a) { this_visitor(const_iterator(this, i, a)); };
+            auto visit_arg = [&](Pos b) { arg_visitor(other_iterator(&o, j, b)); };
+            auto visit_all = [](const Chunk& c, auto visitor) {
+                Pos p = c.first();
+                do {
+                    visitor(p);
+                } while (c.next(p));
+            };
+            while (i < chunks_.size() || j < o.chunks().size()) {
+                if (j == o.chunks().size() || (i < chunks_.size() && chunks_[i].key < o.chunks()[j].key)) {
+                    visit_all(chunks_[i], visit_this);
+                    ++i;
+                } else if (i == chunks_.size() || chunks_[i].key > o.chunks()[j].key) {
+                    visit_all(o.chunks()[j], visit_arg);
+                    ++j;
+                } else {
+                    roaring_container_objs::or_chunks(chunks_[i], o.chunks()[j], visit_this, visit_arg, [&](Pos a, Pos b) {
+                        both_visitor(const_iterator(this, i, a), other_iterator(&o, j, b));
+                    });
+                    ++i;
+                    ++j;
+                }
+            }
+        }
+
+        // the number of elements in both this and o
+        template<typename other_t>
+        size_type and_count(const other_t& o) const {
+            size_type r = 0;
+            std::size_t i = 0;
+            std::size_t j = 0;
+            while (i < chunks_.size() && j < o.chunks().size()) {
+                if (chunks_[i].key < o.chunks()[j].key) {
+                    ++i;
+                } else if (chunks_[i].key > o.chunks()[j].key) {
+                    ++j;
+                } else {
+                    r += roaring_container_objs::and_chunks_count(chunks_[i++], o.chunks()[j++]);
+                }
+            }
+            return r;
+        }
+
+        // ids are mapped to unsigned values which keep the same order
+        static std::uint32_t to_u(id_type id) {
+            if constexpr(std::is_signed_v<id_type>) {
+                return static_cast<std::uint32_t>(static_cast<std::int32_t>(id)) ^ 0x80000000u;
+            } else {
+                return static_cast<std::uint32_t>(id);
+            }
+        }
+
+        static id_type from_u(std::uint32_t u) {
+            if constexpr(std::is_signed_v<id_type>) {
+                return static_cast<id_type>(static_cast<std::int32_t>(u ^ 0x80000000u));
+            } else {
+                return static_cast<id_type>(u);
+            }
+        }
+
+    private:
+        // the index of the first chunk with a key at or after key
+        std::size_t chunk_lower_bound(std::uint16_t key) const {
+            auto it = std::lower_bound(chunks_.begin(), chunks_.end(), key, [](const Chunk& c, std::uint16_t k) { return c.key < k; });
+            return static_cast<std::size_t>(it - chunks_.begin());
+        }
+
+        std::vector<Chunk> chunks_;
+        size_type count;
+};
+
+} // namespace sparse_distributed_representation
@@ -0,0 +1,318 @@
+#pragma once
+
+#include <algorithm>
+#include <assert.h>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "SparseDistributedRepresentation/SDRElem.hpp"
+
+namespace sparse_distributed_representation {
+
+namespace run_container_objs {
+
+// the ids from start to last inclusively
+template<typename id_t>
+struct Run {
+    id_t start;
+    id_t last;
+};
+
+/**
+ * combines two lists of runs with a bitwise op (e.g. std::bit_and), applied to whether an id is in a and whether it is in b.
+ * emit(start, last) is called for each run in the result, in ascending order. the emitted runs don't touch.
+ */
+template<typename a_id_t, typename b_id_t, typename Op, typename Emit>
+void combine_runs(const std::vector<Run<a_id_t>>& a, const std::vector<Run<b_id_t>>& b, Op op, Emit emit) {
+    // each run is a half open interval [start, last + 1), and is entered at the first boundary and left at the second
+    auto boundary = [](const auto& runs, std::size_t k) -> std::int64_t {
+        return k % 2 == 0 ? std::int64_t(runs[k / 2].start) : std::int64_t(runs[k / 2].last) + 1;
+    };
+    constexpr std::int64_t none = std::numeric_limits<std::int64_t>::max();
+    std::size_t i = 0;
+    std::size_t j = 0;
+    bool in_a = false;
+    bool in_b = false;
+    bool in_r = false;
+    std::int64_t r_start = 0;
+    while (i < 2 * a.size() || j < 2 * b.size()) {
+        std::int64_t x_a = i < 2 * a.size() ? boundary(a, i) : none;
+        std::int64_t x_b = j < 2 * b.size() ? boundary(b, j) : none;
+        std::int64_t x = std::min(x_a, x_b);
+        // runs in the same list don't touch, so each list has at most one boundary at x
+        if (x_a == x) {
+            in_a = !in_a;
+            ++i;
+        }
+        if (x_b == x) {
+            in_b = !in_b;
+            ++j;
+        }
+        bool now = (op(unsigned(in_a), unsigned(in_b)) & 1u) != 0;
+        if (now && !in_r) {
+            r_start = x;
+            in_r = true;
+        } else if (!now && in_r) {
+            emit(r_start, x - 1);
+            in_r = false;
+        }
+    }
+}
+
+// the container doesn't store elements (only runs of ids), so the iterator dereferences to an element by value.
+// a position which no longer refers to its element (from an insert or erase elsewhere) is looked up again by id
+template<typename container_t>
+class ConstIterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = typename container_t::value_type;
+        using reference = value_type;
+        using pointer = const value_type*;
+
+        static constexpr std::size_t end_index = static_cast<std::size_t>(-1);
+
+        ConstIterator() : container(nullptr), run(end_index), elem() {}
+
+        ConstIterator(const container_t* container, std::size_t run, typename value_type::id_type id)
+            : container(container), run(run), elem(id) {}
+
+        reference operator*() const { return elem; }
+        pointer operator->() const { return &elem; }
+
+        ConstIterator& operator++() {
+            assert(run != end_index);
+            if (!valid()) {
+                // the runs were changed since this was made
+                *this = container->upper_bound(elem.id());
+                return *this;
+            }
+            const auto& runs = container->runs();
+            if (elem.id() < runs[run].last) {
+                elem = value_type(elem.id() + 1);
+            } else if (++run == runs.size()) {
+                *this = container->end();
+            } else {
+                elem = value_type(runs[run].start);
+            }
+            return *this;
+        }
+
+        ConstIterator operator++(int) { ConstIterator tmp = *this; ++(*this); return tmp; }
+
+        ConstIterator& operator--() {
+            const auto& runs = container->runs();
+            if (run == end_index) {
+                assert(!runs.empty());
+                *this = ConstIterator(container, runs.size() - 1, runs.back().last);
+                return *this;
+            }
+            if (!valid()) {
+                *this = container->lower_bound(elem.id());
+                return --(*this);
+            }
+            if (elem.id() > runs[run].start) {
+                elem = value_type(elem.id() - 1);
+            } else {
+                assert(run != 0);
+                --run;
+                elem = value_type(runs[run].last);
+            }
+            return *this;
+        }
+
+        ConstIterator operator--(int) { ConstIterator tmp = *this; --(*this); return tmp; }
+
+        bool operator==(const ConstIterator& o) const {
+            if (run == end_index || o.run == end_index) return run == o.run;
+            return elem.id() == o.elem.id();
+        }
+
+        bool operator!=(const ConstIterator& o) const { return !(*this == o); }
+
+    private:
+        bool valid() const {
+            const auto& runs = container->runs();
+            return run < runs.size() && runs[run].start <= elem.id() && elem.id() <= runs[run].last;
+        }
+
+        const container_t* container;
+        std::size_t run;
+        value_type elem;
+};
+
+} // namespace run_container_objs
+
+// stores the elements as runs of consecutive ids.
+// this suits encoder outputs (e.g. the SDR float encoders), which are one or two runs regardless of their size.
+// if both operands of an op are RunContainers, then SDR computes the op from the runs, in time proportional to the number of runs.
+//
+// it behaves like a std::set (it can lower_bound, and insert and erase anywhere).
+// iterators are not invalidated by insert or erase, except for the erased element.
+//
+// Only the necessary functions have been implemented (for use in SDR).
+template<typename SDRElem_t>
+class RunContainer {
+    using id_type = typename SDRElem_t::id_type;
+    static_assert(std::is_integral_v<id_type> && sizeof(id_type) <= sizeof(std::int32_t), "RunContainer ids must be integers of at most 32 bits");
+    static_assert(std::is_same_v<typename SDRElem_t::data_type, EmptyData>, "RunContainer can't store data");
+
+    public:
+        using Run = run_container_objs::Run<id_type>;
+
+        using size_type = std::size_t;
+        using value_type = SDRElem_t;
+        using const_iterator = run_container_objs::ConstIterator<RunContainer>;
+        using iterator = const_iterator;
+        using reference = SDRElem_t;
+        using const_reference = SDRElem_t;
+        using pointer = const SDRElem_t*;
+        using const_pointer = const SDRElem_t*;
+
+        RunContainer() : count(0) {}
+
+        size_type size() const { return count; }
+        bool empty() const { return count == 0; }
+
+        const_iterator begin() const { return runs_.empty() ? end() : const_iterator(this, 0, runs_.front().start); }
+        const_iterator end() const { return const_iterator(this, const_iterator::end_index, id_type()); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+
+        const_iterator lower_bound(id_type id) const {
+            std::size_t r = run_lower_bound(id);
+            if (r == runs_.size()) return end();
+            return const_iterator(this, r, std::max(id, runs_[r].start));
+        }
+
+        const_iterator lower_bound(const SDRElem_t& elem) const { return lower_bound(elem.id()); }
+
+        const_iterator upper_bound(id_type id) const {
+            auto it = lower_bound(id);
+            if (it != end() && it->id() == id) ++it;
+            return it;
+        }
+
+        const_iterator upper_bound(const SDRElem_t& elem) const { return upper_bound(elem.id()); }
+
+        const_iterator insert(const SDRElem_t& elem) {
+            id_type id = elem.id();
+            std::size_t r = run_lower_bound(id);
+            if (r < runs_.size() && runs_[r].start <= id) return const_iterator(this, r, id);
+            ++count;
+            bool join_prev = r > 0 && std::int64_t(runs_[r - 1].last) + 1 == id;
+            bool join_next = r < runs_.size() && std::int64_t(id) + 1 == runs_[r].start;
+            if (join_prev && join_next) {
+                runs_[r - 1].last = runs_[r].last;
+                runs_.erase(runs_.begin() + r);
+                --r;
+            } else if (join_prev) {
+                runs_[--r].last = id;
+            } else if (join_next) {
+                runs_[r].start = id;
+            } else {
+                runs_.insert(runs_.begin() + r, Run{id, id});
+            }
+            return const_iterator(this, r, id);
+        }
+
+        // the position is only a hint, same as std::set
+        const_iterator insert(const_iterator, const SDRElem_t& elem) { return insert(elem); }
+
+        const_iterator erase(const_iterator pos) {
+            id_type id = pos->id();
+            std::size_t r = run_lower_bound(id);
+            assert(r < runs_.size() && runs_[r].start <= id);
+            --count;
+            Run& run = runs_[r];
+            if (run.start == run.last) {
+                runs_.erase(runs_.begin() + r);
+            } else if (id == run.start) {
+                ++run.start;
+            } else if (id == run.last) {
+                --run.last;
+            } else {
+                Run after{static_cast<id_type>(id + 1), run.last};
+                run.last = id - 1;
+                runs_.insert(runs_.begin() + r + 1, after);
+            }
+            return upper_bound(id);
+        }
+
+        const_iterator erase(const_iterator first, const_iterator last) {
+            while (first != last) {
+                first = erase(first);
+            }
+            return first;
+        }
+
+        void clear() {
+            runs_.clear();
+            count = 0;
+        }
+
+        // appends the ids from start to last inclusively. they must be after every element in this
+        void push_run(id_type start, id_type last) {
+            assert(start <= last);
+            assert(runs_.empty() || runs_.back().last < start);
+            count += static_cast<size_type>(std::int64_t(last) - start + 1);
+            if (!runs_.empty() && std::int64_t(runs_.back().last) + 1 == start) {
+                runs_.back().last = last;
+            } else {
+                runs_.push_back(Run{start, last});
+            }
+        }
+
+        const std::vector<Run>& runs() const { return runs_; }
+
+        // approximate number of bytes used
+        std::size_t memory_usage() const {
+            return sizeof(*this) + runs_.capacity() * sizeof(Run);
+        }
+
+        // this = op(a, b), run-wise
+        template<typename A, typename B, typename Op>
+        void assign_runs(const A& a, const B& b, Op op) {
+            std::vector<Run> r;
+            size_type c = 0;
+            run_container_objs::combine_runs(a.runs(), b.runs(), op, [&](std::int64_t start, std::int64_t last) {
+                r.push_back(Run{static_cast<id_type>(start), static_cast<id_type>(last)});
+                c += static_cast<size_type>(last - start + 1);
+            });
+            runs_ = std::move(r);
+            count = c;
+        }
+
+        // the number of elements in op(this, o)
+        template<typename B, typename Op>
+        size_type count_runs(const B& o, Op op) const {
+            size_type r = 0;
+            run_container_objs::combine_runs(runs_, o.runs(), op, [&](std::int64_t start, std::int64_t last) {
+                r += static_cast<size_type>(last - start + 1);
+            });
+            return r;
+        }
+
+        // calls visitor(id) for each element in op(this, o), in ascending order
+        template<typename B, typename Op, typename Visitor>
+        void visit_runs(const B& o, Op op, Visitor visitor) const {
+            run_container_objs::combine_runs(runs_, o.runs(), op, [&](std::int64_t start, std::int64_t last) {
+                for (std::int64_t id = start; id <= last; ++id) visitor(static_cast<id_type>(id));
+            });
+        }
+
+    private:
+        // the index of the first run which ends at or after id
+        std::size_t run_lower_bound(id_type id) const {
+            auto it = std::lower_bound(runs_.begin(), runs_.end(), id, [](const Run& r, id_type val) { return r.last < val; });
+            return static_cast<std::size_t>(it - runs_.begin());
+        }
+
+        std::vector<Run> runs_;
+        size_type count;
+};
+
+} // namespace sparse_distributed_representation
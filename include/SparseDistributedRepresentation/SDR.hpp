@@ -10,6 +10,8 @@
 #include "SparseDistributedRepresentation/Templates.hpp"
 #include "SparseDistributedRepresentation/SDRElem.hpp" 
 #include "SparseDistributedRepresentation/MatrixUtils.hpp"
+#include "SparseDistributedRepresentation/OverlapStats.hpp"
+#include "SparseDistributedRepresentation/IntersectKernels.hpp"
 
 namespace sparse_distributed_representation {
 
@@ -39,6 +41,10 @@ class SDR {
         static constexpr bool uses_vector_like = vector_like<container_t>::value;
         static constexpr bool uses_flist_like = flist_like<container_t>::value;
         static constexpr bool uses_set_like = set_like<container_t>::value;
+        static constexpr bool uses_bitset_like = bitset_like<container_t>::value;
+        static constexpr bool uses_chunked_like = chunked_like<container_t>::value;
+        static constexpr bool uses_compressed_like = compressed_like<container_t>::value;
+        static constexpr bool uses_run_like = run_like<container_t>::value;
 
         static_assert(!std::is_fundamental<SDRElem_t>::value, "Instead of SDR<fundamental_type_here>, use SDR<SDRElem_t<fundamental_type_here>>");
         static_assert(!uses_set_like || set_comparator_check<container_t>::value, "Bad comparator for container! instead of std::less<T>, use std::less<>");
@@ -49,6 +55,29 @@ class SDR {
                 this->maybe_size.size = 0;
         }
 
+        /**
+         * Allocator ctor. The underlying container is constructed with the allocator.
+         * e.g. for a std::pmr container, this can be a std::pmr::memory_resource*.
+         *
+         * Op results (and the rows of matrix results) are made with the same allocator as this.
+         * So if the operands are allocated in an arena (e.g. a std::pmr::monotonic_buffer_resource), then so are the results.
+         */
+        template<typename Alloc, typename = std::enable_if_t<std::uses_allocator_v<container_t, Alloc>>>
+        explicit SDR(const Alloc& alloc) : v(alloc) {
+            if constexpr(uses_flist_like)
+                this->maybe_size.size = 0;
+        }
+
+        /**
+         * Container ctor. The container is used as is, e.g. a view of elements which are stored elsewhere.
+         * The elements must already be in ascending order and with no duplicates.
+         */
+        explicit SDR(container_t container) : v(std::move(container)) {
+            if constexpr(uses_flist_like)
+                this->maybe_size.size = static_cast<size_type>(std::distance(v.cbegin(), v.cend()));
+            assert(is_ascending() && "Elements must be in ascending order and with no duplicates.");
+        }
+
         // copy ctor
         SDR(const SDR& sdr): v(sdr.v) {
             if constexpr(uses_flist_like)
@@ -187,10 +216,18 @@ class SDR {
          * apply an and visitor. Perform an operation on each element in this AND in the arg.
          * each selected element pair is called in the visitor as visitor(iterator this_position, c_arg_t::iterator arg_position)
          * the visitor should not invalidate proceeding iterators (after this_position or arg_position)
+         * if both containers are vector-like, this chooses between a linear merge and a galloping search based on the size ratio
+         * if both containers store their ids contiguously, then the linear merge uses the simd kernels in IntersectKernels.hpp
+         * if both containers are chunked, then each pair of matching chunks is intersected directly (the visitor must not insert or erase)
+         * if either container is compressed, then both sides are walked together so the ids are decoded as a stream
          */
         template<typename arg_t, typename c_arg_t, typename Visitor>
         void andv(SDR<arg_t, c_arg_t>& arg, Visitor visitor) {
-            andv(arg, visitor, v.begin(), v.end(), arg.v.begin(), arg.v.end());
+            if constexpr(chunk_wise<c_arg_t>) {
+                v.and_visit(arg.v, visitor);
+            } else {
+                andv(arg, visitor, v.begin(), v.end(), arg.v.begin(), arg.v.end());
+            }
         }
         
         template<typename arg_t, typename c_arg_t, typename Visitor>
@@ -257,6 +294,15 @@ class SDR {
         template<typename arg_t, typename c_arg_t>
         size_type xors(const SDR<arg_t, c_arg_t>& arg) const;
 
+        /**
+         * bounded xor size. same as xors, but it stops early once the distance is known to exceed the limit.
+         * the remaining elements always add at least the difference in the remaining sizes to the distance.
+         *
+         * @return the number of elements in this xor arg if it is at most the limit. otherwise, some value greater than the limit.
+         */
+        template<typename arg_t, typename c_arg_t>
+        size_type xors_bounded(const SDR<arg_t, c_arg_t>& arg, size_type limit) const;
+
         /**
          * apply an or visitor. Perform an operation on each element in this OR in arg
          * three visitors are defined:
@@ -264,6 +310,7 @@ class SDR {
          *      the element is only in the arg: arg_visitor(c_arg_t::iterator arg_position)
          *      the element is in both: both_visitor(iterator this_position, c_arg_t::iterator arg_position)
          * the visitors must not invalidate proceeding iterators (one after this_position or one after arg_position)
+         * if both containers are chunked, then each pair of matching chunks is merged directly (the visitors must not insert or erase)
          */
         template<typename arg_t, typename c_arg_t, typename ThisVisitor, typename QueryVisitor, typename BothVisitor>
         void orv(SDR<arg_t, c_arg_t>& arg, ThisVisitor this_visitor, QueryVisitor arg_visitor, BothVisitor both_visitor);
@@ -317,6 +364,15 @@ class SDR {
         template<typename arg_t, typename c_arg_t>
         size_type rms(const SDR<arg_t, c_arg_t>& arg) const;
 
+        /**
+         * all of the op sizes (ands, ors, xors, rms) at once.
+         * this is a single pass over both SDRs, instead of one pass per size.
+         * 
+         * @return the sizes, which also give the jaccard, dice, and cosine similarity.
+         */
+        template<typename arg_t, typename c_arg_t>
+        OverlapStats<size_type> overlap_stats(const SDR<arg_t, c_arg_t>& arg) const;
+
         /**
          * Shift the elements in this.
          * 
@@ -357,6 +413,20 @@ class SDR {
         template<typename T = container_t>
         void shrink_to_fit() { v.shrink_to_fit(); }
 
+        // calls get_allocator on the underlying container
+        template<typename T = container_t>
+        typename T::allocator_type get_allocator() const { return v.get_allocator(); }
+
+        // an empty SDR, which uses the same allocator as this if it can
+        template<typename sdr_t>
+        sdr_t make_empty() const {
+            if constexpr(shares_allocator<container_t, typename sdr_t::container_type>::value) {
+                return sdr_t(v.get_allocator());
+            } else {
+                return sdr_t();
+            }
+        }
+
         template<typename T = container_t>
         void reserve(size_type n) { v.reserve(n); }
 
@@ -513,6 +583,8 @@ class SDR {
         SDR<ret_t, c_ret_t> col_major_mul_vec(const SDR<arg_t, c_arg_t>& arg) const;
 
         // this returns a matrix of the same type, to prevent template proliferation.
+        // if the result is stored in vectors and the minor ids are integers in a compact range, then it's a counting sort (O(nnz)).
+        // otherwise, or if a LoserTreeQueue or BucketQueue is given, the elements are merged through an OtherMajorView.
         template<typename ret_t = SDRElem_t,
                 typename c_ret_t = container_t,
                 typename priority_queue_t = std::priority_queue<matrix_utils::row_info<value_type>>>
@@ -540,12 +612,17 @@ class SDR {
          * Multiply two matrices together.
          * 
          * Both this and the arg must have the same row/column major format.
+         *
+         * @tparam accumulator_t if void, each output row merges the selected rows of the arg through an OtherMajorView.
+         *                       otherwise, each output row is accumulated by column (Gustavson's method), e.g. with a
+         *                       matrix_utils::DenseAccumulator or matrix_utils::HashAccumulator of the output row's elements.
          */
         template<typename arg_t,
                 typename c_arg_t,
                 typename ret_t = arg_t,
                 typename c_ret_t = c_arg_t,
-                typename priority_queue_t = std::priority_queue<matrix_utils::row_info<arg_t>>>
+                typename priority_queue_t = std::priority_queue<matrix_utils::row_info<arg_t>>,
+                typename accumulator_t = void>
         SDR<ret_t, c_ret_t> same_mul(const SDR<arg_t, c_arg_t>& arg) const;
 
         /**
@@ -574,6 +651,37 @@ class SDR {
 
         MaybeSize<container_t> maybe_size;
 
+        // if one SDR is this many times larger than the other, then searching is faster than a linear merge
+        static constexpr size_type gallop_ratio = 8;
+
+        // if both this and the arg are bitsets over the same universe, then ops can be done word-wise
+        template<typename c_arg_t>
+        static constexpr bool word_wise = same_universe<container_t, c_arg_t>::value;
+
+        // if both this and the arg are chunked, then andv, orv, and the size ops work chunk against chunk
+        template<typename c_arg_t>
+        static constexpr bool chunk_wise = chunked_like<container_t>::value && chunked_like<c_arg_t>::value;
+
+        // if both this and the arg are runs of ids, then ops can be done run-wise
+        template<typename c_arg_t>
+        static constexpr bool run_wise = run_like<container_t>::value && run_like<c_arg_t>::value;
+
+        // computes op(this, arg) word-wise, and places the result in a new SDR
+        template<typename ret_t, typename c_ret_t, typename arg_t, typename c_arg_t, typename Op>
+        SDR<ret_t, c_ret_t> word_wise_op(const SDR<arg_t, c_arg_t>& arg, Op op) const;
+
+        // computes op(this, arg) run-wise, and places the result in a new SDR
+        template<typename ret_t, typename c_ret_t, typename arg_t, typename c_arg_t, typename Op>
+        SDR<ret_t, c_ret_t> run_wise_op(const SDR<arg_t, c_arg_t>& arg, Op op) const;
+
+        // whether the ids are similar enough in size that the simd kernels should be used instead of galloping
+        template<typename c_arg_t>
+        bool use_intersect_kernels(const c_arg_t& arg) const {
+            auto this_size = v.size();
+            auto arg_size = arg.size();
+            return this_size * gallop_ratio >= arg_size && arg_size * gallop_ratio >= this_size;
+        }
+
         // used in the output stream op
         static constexpr bool print_type = false;
 
@@ -698,7 +806,13 @@ SDR<SDRElem_t, container_t>::SDR(float input, float period, size_type size, size
         // the number of elements that don't wrap off the end
         size_type non_wrapped_elements = size - wrapped_elements;
 
-        if constexpr(uses_flist_like) {
+        if constexpr(uses_run_like) {
+            using id_type = typename SDRElem_t::id_type;
+            v.push_run(0, static_cast<id_type>(wrapped_elements - 1));
+            if (non_wrapped_elements != 0) {
+                v.push_run(static_cast<id_type>(start_index), static_cast<id_type>(start_index + non_wrapped_elements - 1));
+            }
+        } else if constexpr(uses_flist_like) {
             auto insert_it = v.before_begin();
             for (size_type i = 0; i < wrapped_elements; ++i) {
                 insert_it = v.insert_after(insert_it, SDRElem_t(i));
@@ -723,7 +837,12 @@ SDR<SDRElem_t, container_t>::SDR(float input, float period, size_type size, size
         }
     } else {
         // no elements are wrapped from the end
-        if constexpr(uses_flist_like) {
+        if constexpr(uses_run_like) {
+            if (size != 0) {
+                using id_type = typename SDRElem_t::id_type;
+                v.push_run(static_cast<id_type>(start_index), static_cast<id_type>(start_index + size - 1));
+            }
+        } else if constexpr(uses_flist_like) {
             auto insert_it = v.before_begin();
             for (size_type i = 0; i < size; ++i) {
                 insert_it = v.insert_after(insert_it, SDRElem_t(start_index + i));
@@ -749,7 +868,13 @@ SDR<SDRElem_t, container_t>::SDR(float input, size_type size, size_type underlyi
     assert(input >= 0);
     if constexpr(uses_vector_like) v.resize(size);
     size_type start_index = std::round((underlying_array_length - size) * input);
-    if constexpr(uses_flist_like) {
+    if constexpr(uses_run_like) {
+        // a single run, regardless of the size
+        if (size != 0) {
+            using id_type = typename SDRElem_t::id_type;
+            v.push_run(static_cast<id_type>(start_index), static_cast<id_type>(start_index + size - 1));
+        }
+    } else if constexpr(uses_flist_like) {
         auto insert_it = v.before_begin();
         for (size_type i = 0; i < size; ++i) {
             insert_it = v.insert_after(insert_it, SDRElem_t(start_index + i));
@@ -859,6 +984,12 @@ void SDR<SDRElem_t, container_t>::data_visitor(Visitor visitor) {
 
 template<typename SDRElem_t, typename container_t>
 const typename SDRElem_t::data_type* SDR<SDRElem_t, container_t>::ande(typename SDRElem_t::id_type val) const {
+    if constexpr(uses_set_like && !std::is_reference_v<const_reference>) {
+        // the container doesn't store elements (e.g. BitsetContainer), so there isn't any data to point to
+        static const typename SDRElem_t::data_type empty;
+        auto pos = v.lower_bound(val);
+        return pos == v.cend() || pos->id() != val ? NULL : &empty;
+    }
     decltype(std::lower_bound(v.cbegin(), v.cend(), val)) pos;
     if constexpr(uses_set_like) {
         pos = v.lower_bound(val);
@@ -882,7 +1013,7 @@ template<typename SDRElem_t, typename container_t>
 template<typename ret_t, typename c_ret_t, typename arg_t>
 SDR<ret_t, c_ret_t> SDR<SDRElem_t, container_t>::ande(arg_t start_inclusive, arg_t stop_exclusive) const {
     assert(start_inclusive <= stop_exclusive);
-    SDR<ret_t, c_ret_t> sdr;
+    SDR<ret_t, c_ret_t> sdr = make_empty<SDR<ret_t, c_ret_t>>();
     typename container_t::const_iterator start_it;
     if constexpr(uses_set_like) {
         start_it = v.lower_bound(start_inclusive);
@@ -955,9 +1086,135 @@ typename SDR<SDRElem_t, container_t>::size_type SDR<SDRElem_t, container_t>::and
     }
 }
 
+// word-wise equivalent of rm
+struct bit_rm {
+    template<typename T>
+    T operator()(T a, T b) const { return a & ~b; }
+};
+
+template<typename SDRElem_t, typename container_t>
+template<typename ret_t, typename c_ret_t, typename arg_t, typename c_arg_t, typename Op>
+SDR<ret_t, c_ret_t> SDR<SDRElem_t, container_t>::word_wise_op(const SDR<arg_t, c_arg_t>& arg, Op op) const {
+    SDR<ret_t, c_ret_t> r = make_empty<SDR<ret_t, c_ret_t>>();
+    if constexpr(same_universe<c_ret_t, container_t>::value) {
+        r.v.assign_words(v, arg.v, op);
+    } else if constexpr(flist_like<c_ret_t>::value) {
+        auto it = r.v.before_begin();
+        v.visit_words(arg.v, op, [&](std::size_t id) {
+            it = r.v.insert_after(it, ret_t(static_cast<typename ret_t::id_type>(id)));
+            ++r.maybe_size.size;
+        });
+    } else {
+        // sparse extraction of the set bits
+        if constexpr(vector_like<c_ret_t>::value) r.v.reserve(v.count_words(arg.v, op));
+        v.visit_words(arg.v, op, [&](std::size_t id) {
+            r.push_back(ret_t(static_cast<typename ret_t::id_type>(id)));
+        });
+    }
+    return r; // nrvo
+}
+
+template<typename SDRElem_t, typename container_t>
+template<typename ret_t, typename c_ret_t, typename arg_t, typename c_arg_t, typename Op>
+SDR<ret_t, c_ret_t> SDR<SDRElem_t, container_t>::run_wise_op(const SDR<arg_t, c_arg_t>& arg, Op op) const {
+    SDR<ret_t, c_ret_t> r = make_empty<SDR<ret_t, c_ret_t>>();
+    if constexpr(run_like<c_ret_t>::value) {
+        r.v.assign_runs(v, arg.v, op);
+    } else if constexpr(flist_like<c_ret_t>::value) {
+        auto it = r.v.before_begin();
+        v.visit_runs(arg.v, op, [&](typename SDRElem_t::id_type id) {
+            it = r.v.insert_after(it, ret_t(static_cast<typename ret_t::id_type>(id)));
+            ++r.maybe_size.size;
+        });
+    } else {
+        if constexpr(vector_like<c_ret_t>::value) r.v.reserve(v.count_runs(arg.v, op));
+        v.visit_runs(arg.v, op, [&](typename SDRElem_t::id_type id) {
+            r.push_back(ret_t(static_cast<typename ret_t::id_type>(id)));
+        });
+    }
+    return r; // nrvo
+}
+
+// exponential search. same result as std::lower_bound, but looks near the beginning of the range first.
+// this is faster when the element is expected to be close to first (e.g. when walking a large SDR with a small SDR)
+template<typename Iterator, typename T>
+Iterator gallop_lower_bound(Iterator first, Iterator last, const T& val) {
+    using difference_type = typename std::iterator_traits<Iterator>::difference_type;
+    if (first == last || !(first->id() < val)) return first;
+    difference_type remaining = std::distance(first, last);
+    // the element at lo is known to be less than val
+    difference_type lo = 0;
+    difference_type hi = 1;
+    while (hi < remaining && std::next(first, hi)->id() < val) {
+        lo = hi;
+        hi *= 2;
+    }
+    if (hi > remaining) hi = remaining;
+    return std::lower_bound(std::next(first, lo + 1), std::next(first, hi), val);
+}
+
 template<typename SDRElem_t, typename container_t>
 template<typename arg_t, typename c_arg_t, typename Visitor>
 void SDR<SDRElem_t, container_t>::andv(SDR<arg_t, c_arg_t>& arg, Visitor visitor, iterator this_pos, iterator this_end, typename c_arg_t::iterator arg_pos, typename c_arg_t::iterator arg_end) {
+    if constexpr(uses_vector_like && vector_like<c_arg_t>::value) {
+        // if one side is much larger than the other, then walk the smaller side and gallop through the larger side.
+        // otherwise, a linear merge is faster than searching
+        auto this_size = std::distance(this_pos, this_end);
+        auto arg_size = std::distance(arg_pos, arg_end);
+        auto ratio = static_cast<decltype(this_size)>(gallop_ratio);
+        if (this_size * ratio < arg_size) {
+            while (this_pos != this_end) {
+                arg_pos = gallop_lower_bound(arg_pos, arg_end, this_pos->id());
+                if (arg_pos == arg_end) return;
+                if (arg_pos->id() == this_pos->id()) {
+                    visitor(this_pos++, arg_pos++);
+                } else {
+                    ++this_pos;
+                }
+            }
+        } else if (arg_size * ratio < this_size) {
+            while (arg_pos != arg_end) {
+                this_pos = gallop_lower_bound(this_pos, this_end, arg_pos->id());
+                if (this_pos == this_end) return;
+                if (this_pos->id() == arg_pos->id()) {
+                    visitor(this_pos++, arg_pos++);
+                } else {
+                    ++arg_pos;
+                }
+            }
+        } else if constexpr(intersect_kernels::applies<container_t, c_arg_t>::value) {
+            const auto* this_ids = intersect_kernels::contiguous_ids<container_t>::ids(v) + std::distance(v.begin(), this_pos);
+            const auto* arg_ids = intersect_kernels::contiguous_ids<c_arg_t>::ids(arg.v) + std::distance(arg.v.begin(), arg_pos);
+            auto kernel_visitor = [&](std::size_t this_index, std::size_t arg_index) {
+                visitor(std::next(this_pos, this_index), std::next(arg_pos, arg_index));
+            };
+            intersect_kernels::intersect(this_ids, this_size, arg_ids, arg_size, kernel_visitor);
+        } else {
+            while (this_pos != this_end && arg_pos != arg_end) {
+                if (this_pos->id() < arg_pos->id()) {
+                    ++this_pos;
+                } else if (this_pos->id() > arg_pos->id()) {
+                    ++arg_pos;
+                } else {
+                    visitor(this_pos++, arg_pos++);
+                }
+            }
+        }
+        return;
+    } else if constexpr(uses_compressed_like || compressed_like<c_arg_t>::value) {
+        // searching would restart the decoding each time, so a linear merge is used instead
+        while (this_pos != this_end && arg_pos != arg_end) {
+            if (this_pos->id() < arg_pos->id()) {
+                ++this_pos;
+            } else if (this_pos->id() > arg_pos->id()) {
+                ++arg_pos;
+            } else {
+                visitor(this_pos++, arg_pos++);
+            }
+        }
+        return;
+    }
+
     typename SDRElem_t::id_type this_elem;
     typename arg_t::id_type arg_elem;
 
@@ -999,7 +1256,9 @@ void SDR<SDRElem_t, container_t>::andv(SDR<arg_t, c_arg_t>& arg, Visitor visitor
 template<typename SDRElem_t, typename container_t>
 template<typename ret_t, typename c_ret_t, typename arg_t, typename c_arg_t>
 SDR<ret_t, c_ret_t> SDR<SDRElem_t, container_t>::ande(const SDR<arg_t, c_arg_t>& arg) const {
-    SDR<ret_t, c_ret_t> r;
+    if constexpr(word_wise<c_arg_t>) return word_wise_op<ret_t, c_ret_t>(arg, std::bit_and<>());
+    if constexpr(run_wise<c_arg_t>) return run_wise_op<ret_t, c_ret_t>(arg, std::bit_and<>());
+    SDR<ret_t, c_ret_t> r = make_empty<SDR<ret_t, c_ret_t>>();
     if constexpr(flist_like<c_ret_t>::value) {
         auto it = r.v.before_begin();
         auto visitor = [&](iterator this_pos, typename c_arg_t::iterator arg_pos) {
@@ -1027,7 +1286,14 @@ SDR<ret_t, c_ret_t> SDR<SDRElem_t, container_t>::ande(const SDR<arg_t, c_arg_t>&
 template<typename SDRElem_t, typename container_t>
 template<typename arg_t, typename c_arg_t>
 SDR<SDRElem_t, container_t>& SDR<SDRElem_t, container_t>::andi(const SDR<arg_t, c_arg_t>& arg) {
-    if constexpr(uses_vector_like) {
+    if constexpr(word_wise<c_arg_t>) {
+        v.assign_words(v, arg.v, std::bit_and<>());
+    } else if constexpr(run_wise<c_arg_t>) {
+        v.assign_runs(v, arg.v, std::bit_and<>());
+    } else if constexpr(chunk_wise<c_arg_t> || uses_compressed_like) {
+        // the chunk-wise andv doesn't allow erasing from within the visitor, and compressed containers can't erase
+        *this = ande(arg);
+    } else if constexpr(uses_vector_like) {
         auto pos = this->v.begin();
         auto visitor = [&](iterator this_pos, typename c_arg_t::iterator arg_pos) {
             typename SDRElem_t::data_type& data = this_pos->data().andi(arg_pos->data());
@@ -1083,6 +1349,17 @@ SDR<SDRElem_t, container_t>& SDR<SDRElem_t, container_t>::andi(const SDR<arg_t,
 template<typename SDRElem_t, typename container_t>
 template<typename arg_t, typename c_arg_t>
 typename SDR<SDRElem_t, container_t>::size_type SDR<SDRElem_t, container_t>::ands(const SDR<arg_t, c_arg_t>& arg) const {
+    if constexpr(word_wise<c_arg_t>) return v.count_words(arg.v, std::bit_and<>());
+    if constexpr(run_wise<c_arg_t>) return v.count_runs(arg.v, std::bit_and<>());
+    if constexpr(chunk_wise<c_arg_t>) return v.and_count(arg.v);
+    if constexpr(intersect_kernels::applies<container_t, c_arg_t>::value
+            && std::is_same_v<typename SDRElem_t::data_type, EmptyData> && std::is_same_v<typename arg_t::data_type, EmptyData>) {
+        // the data doesn't affect the result, so only the ids need to be counted
+        if (use_intersect_kernels(arg.v)) {
+            return intersect_kernels::intersect_count(intersect_kernels::contiguous_ids<container_t>::ids(v), v.size(),
+                                                      intersect_kernels::contiguous_ids<c_arg_t>::ids(arg.v), arg.v.size());
+        }
+    }
     size_type r = 0;
     auto visitor = [&](iterator this_pos, typename c_arg_t::iterator arg_pos) {
         auto count = this_pos->data().ands(arg_pos->data());
@@ -1169,7 +1446,11 @@ void orv(ThisIterator this_pos, ThisIterator this_end, QueryIterator arg_pos, Qu
 template<typename SDRElem_t, typename container_t>
 template<typename arg_t, typename c_arg_t, typename ThisVisitor, typename QueryVisitor, typename BothVisitor>
 void SDR<SDRElem_t, container_t>::orv(SDR<arg_t, c_arg_t>& arg, ThisVisitor this_visitor, QueryVisitor arg_visitor, BothVisitor both_visitor) {
-    sparse_distributed_representation::orv(this->v.begin(), this->v.end(), arg.v.begin(), arg.v.end(), this_visitor, arg_visitor, both_visitor);
+    if constexpr(chunk_wise<c_arg_t>) {
+        v.or_visit(arg.v, this_visitor, arg_visitor, both_visitor);
+    } else {
+        sparse_distributed_representation::orv(this->v.begin(), this->v.end(), arg.v.begin(), arg.v.end(), this_visitor, arg_visitor, both_visitor);
+    }
 }
 
 // wraps the iterator form with the object form
@@ -1180,9 +1461,9 @@ void SDR<SDRElem_t, container_t>::orv(SDR<arg_t, c_arg_t>& arg, ThisVisitor this
 }
 
 // iterator form. exposed to ore for rvalue and lvalue overloads
+// the result is built in r, which should be empty
 template<typename ret_t, typename c_ret_t, typename MeIterator, typename QueryIterator>
-SDR<ret_t, c_ret_t> ore(MeIterator this_begin, MeIterator this_end, QueryIterator arg_begin, QueryIterator arg_end) {
-    SDR<ret_t, c_ret_t> r;
+SDR<ret_t, c_ret_t> ore(MeIterator this_begin, MeIterator this_end, QueryIterator arg_begin, QueryIterator arg_end, SDR<ret_t, c_ret_t> r = SDR<ret_t, c_ret_t>()) {
     if constexpr(flist_like<c_ret_t>::value) {
         auto it = r.before_begin();
         auto this_visitor = [&](MeIterator this_pos) {
@@ -1225,14 +1506,18 @@ SDR<ret_t, c_ret_t> ore(MeIterator this_begin, MeIterator this_end, QueryIterato
 template<typename SDRElem_t, typename container_t>
 template<typename ret_t, typename c_ret_t, typename arg_t, typename c_arg_t>
 SDR<ret_t, c_ret_t> SDR<SDRElem_t, container_t>::ore(const SDR<arg_t, c_arg_t>& arg) const {
-    return sparse_distributed_representation::ore<ret_t, c_ret_t>(this->cbegin(), this->cend(), arg.cbegin(), arg.cend());
+    if constexpr(word_wise<c_arg_t>) return word_wise_op<ret_t, c_ret_t>(arg, std::bit_or<>());
+    if constexpr(run_wise<c_arg_t>) return run_wise_op<ret_t, c_ret_t>(arg, std::bit_or<>());
+    return sparse_distributed_representation::ore<ret_t, c_ret_t>(this->cbegin(), this->cend(), arg.cbegin(), arg.cend(), make_empty<SDR<ret_t, c_ret_t>>());
 }
 
 // exposing rval overload from iterator forms
 template<typename SDRElem_t, typename container_t>
 template<typename ret_t, typename c_ret_t, typename arg_t, typename c_arg_t>
 SDR<ret_t, c_ret_t> SDR<SDRElem_t, container_t>::ore(SDR<arg_t, c_arg_t>&& arg) const {
-    return sparse_distributed_representation::ore<ret_t, c_ret_t>(this->cbegin(), this->cend(), std::make_move_iterator(arg.v.begin()), std::make_move_iterator(arg.v.end()));
+    if constexpr(word_wise<c_arg_t>) return word_wise_op<ret_t, c_ret_t>(arg, std::bit_or<>());
+    if constexpr(run_wise<c_arg_t>) return run_wise_op<ret_t, c_ret_t>(arg, std::bit_or<>());
+    return sparse_distributed_representation::ore<ret_t, c_ret_t>(this->cbegin(), this->cend(), std::make_move_iterator(arg.v.begin()), std::make_move_iterator(arg.v.end()), make_empty<SDR<ret_t, c_ret_t>>());
 }
 
 // iterator form, exposed to ori for const lval and rval overloads
@@ -1240,7 +1525,7 @@ template<typename SDRElem_t, typename container_t, typename QueryIterator>
 SDR<SDRElem_t, container_t>& ori(SDR<SDRElem_t, container_t>& me, QueryIterator arg_begin, QueryIterator arg_end) {
     using const_iterator = typename SDR<SDRElem_t, container_t>::const_iterator;
     if constexpr(vector_like<container_t>::value) {
-        auto r = ore<SDRElem_t, container_t>(std::make_move_iterator(me.v.begin()), std::make_move_iterator(me.v.end()), arg_begin, arg_end);
+        auto r = ore<SDRElem_t, container_t>(std::make_move_iterator(me.v.begin()), std::make_move_iterator(me.v.end()), arg_begin, arg_end, me.template make_empty<SDR<SDRElem_t, container_t>>());
         me = std::move(r);
     } else if constexpr(flist_like<container_t>::value) {
         auto lagger = me.before_begin();
@@ -1276,24 +1561,55 @@ SDR<SDRElem_t, container_t>& ori(SDR<SDRElem_t, container_t>& me, QueryIterator
 template<typename SDRElem_t, typename container_t>
 template<typename arg_t, typename c_arg_t>
 SDR<SDRElem_t, container_t>& SDR<SDRElem_t, container_t>::ori(const SDR<arg_t, c_arg_t>& arg) {
-    return sparse_distributed_representation::ori(*this, arg.cbegin(), arg.cend());
+    if constexpr(word_wise<c_arg_t>) {
+        v.assign_words(v, arg.v, std::bit_or<>());
+        return *this;
+    } else if constexpr(run_wise<c_arg_t>) {
+        v.assign_runs(v, arg.v, std::bit_or<>());
+        return *this;
+    } else if constexpr(uses_compressed_like) {
+        // compressed containers can only append
+        *this = ore(arg);
+        return *this;
+    } else {
+        return sparse_distributed_representation::ori(*this, arg.cbegin(), arg.cend());
+    }
 }
 
 // exposing rval overload from iterator forms
 template<typename SDRElem_t, typename container_t>
 template<typename arg_t, typename c_arg_t>
 SDR<SDRElem_t, container_t>& SDR<SDRElem_t, container_t>::ori(SDR<arg_t, c_arg_t>&& arg) {
-    if constexpr(uses_set_like && set_like<c_arg_t>::value && std::is_same_v<SDRElem_t, arg_t> && sizeof(typename SDRElem_t::data_type) == 0) {
+    if constexpr(word_wise<c_arg_t>) {
+        v.assign_words(v, arg.v, std::bit_or<>());
+        return *this;
+    } else if constexpr(run_wise<c_arg_t>) {
+        v.assign_runs(v, arg.v, std::bit_or<>());
+        return *this;
+    } else if constexpr(uses_set_like && has_merge<container_t>::value && std::is_same_v<container_t, c_arg_t> && std::is_same_v<SDRElem_t, arg_t> && sizeof(typename SDRElem_t::data_type) == 0) {
         // a specialization which can use c++17 stl set::merge
         v.merge(std::move(arg.v));
         return *this;
+    } else if constexpr(uses_compressed_like) {
+        *this = ore(std::move(arg));
+        return *this;
+    } else {
+        return sparse_distributed_representation::ori(*this, std::make_move_iterator(arg.v.begin()), std::make_move_iterator(arg.v.end()));
     }
-    return sparse_distributed_representation::ori(*this, std::make_move_iterator(arg.v.begin()), std::make_move_iterator(arg.v.end()));
 }
 
 template<typename SDRElem_t, typename container_t>
 template<typename arg_t, typename c_arg_t>
 typename SDR<SDRElem_t, container_t>::size_type SDR<SDRElem_t, container_t>::ors(const SDR<arg_t, c_arg_t>& arg) const {
+    if constexpr(word_wise<c_arg_t>) return v.count_words(arg.v, std::bit_or<>());
+    if constexpr(run_wise<c_arg_t>) return v.count_runs(arg.v, std::bit_or<>());
+    if constexpr(chunk_wise<c_arg_t>) return size() + arg.size() - v.and_count(arg.v);
+    if constexpr(intersect_kernels::applies<container_t, c_arg_t>::value) {
+        if (use_intersect_kernels(arg.v)) {
+            return this->size() + arg.size() - intersect_kernels::intersect_count(intersect_kernels::contiguous_ids<container_t>::ids(v), v.size(),
+                                                                                  intersect_kernels::contiguous_ids<c_arg_t>::ids(arg.v), arg.v.size());
+        }
+    }
     size_type overlap = 0;
     auto visitor = [&](iterator, typename c_arg_t::iterator) {
         // same relevance assumption mentioned in ore
@@ -1304,9 +1620,9 @@ typename SDR<SDRElem_t, container_t>::size_type SDR<SDRElem_t, container_t>::ors
 }
 
 // iterator form, exposed to xore for const lval and rval overloads
+// the result is built in r, which should be empty
 template<typename ret_t, typename c_ret_t, typename MeIterator, typename QueryIterator>
-SDR<ret_t, c_ret_t> xore(MeIterator this_begin, MeIterator this_end, QueryIterator arg_begin, QueryIterator arg_end) {
-    SDR<ret_t, c_ret_t> r;
+SDR<ret_t, c_ret_t> xore(MeIterator this_begin, MeIterator this_end, QueryIterator arg_begin, QueryIterator arg_end, SDR<ret_t, c_ret_t> r = SDR<ret_t, c_ret_t>()) {
     // scoping weirdness requires declaring 'it' here
     // if it was instead declared inside the flist_like branch below (in the same line it is initialized),
     // then it would be no longer valid by the time the lambdas are used in orv
@@ -1352,14 +1668,18 @@ SDR<ret_t, c_ret_t> xore(MeIterator this_begin, MeIterator this_end, QueryIterat
 template<typename SDRElem_t, typename container_t>
 template<typename ret_t, typename c_ret_t, typename arg_t, typename c_arg_t>
 SDR<ret_t, c_ret_t> SDR<SDRElem_t, container_t>::xore(const SDR<arg_t, c_arg_t>& arg) const {
-    return sparse_distributed_representation::xore<ret_t, c_ret_t>(this->cbegin(), this->cend(), arg.cbegin(), arg.cend());
+    if constexpr(word_wise<c_arg_t>) return word_wise_op<ret_t, c_ret_t>(arg, std::bit_xor<>());
+    if constexpr(run_wise<c_arg_t>) return run_wise_op<ret_t, c_ret_t>(arg, std::bit_xor<>());
+    return sparse_distributed_representation::xore<ret_t, c_ret_t>(this->cbegin(), this->cend(), arg.cbegin(), arg.cend(), make_empty<SDR<ret_t, c_ret_t>>());
 }
 
 // exposing rval overload from iterator forms
 template<typename SDRElem_t, typename container_t>
 template<typename ret_t, typename c_ret_t, typename arg_t, typename c_arg_t>
 SDR<ret_t, c_ret_t> SDR<SDRElem_t, container_t>::xore(SDR<arg_t, c_arg_t>&& arg) const {
-    return sparse_distributed_representation::xore<ret_t, c_ret_t>(this->cbegin(), this->cend(), std::make_move_iterator(arg.v.begin()), std::make_move_iterator(arg.v.end()));
+    if constexpr(word_wise<c_arg_t>) return word_wise_op<ret_t, c_ret_t>(arg, std::bit_xor<>());
+    if constexpr(run_wise<c_arg_t>) return run_wise_op<ret_t, c_ret_t>(arg, std::bit_xor<>());
+    return sparse_distributed_representation::xore<ret_t, c_ret_t>(this->cbegin(), this->cend(), std::make_move_iterator(arg.v.begin()), std::make_move_iterator(arg.v.end()), make_empty<SDR<ret_t, c_ret_t>>());
 }
 
 // iterator form, exposed to ori for const lval and rval overloads
@@ -1367,7 +1687,7 @@ template<typename SDRElem_t, typename container_t, typename QueryIterator>
 SDR<SDRElem_t, container_t>& xori(SDR<SDRElem_t, container_t>& me, QueryIterator arg_begin, QueryIterator arg_end) {
     using const_iterator = typename SDR<SDRElem_t, container_t>::const_iterator;
     if constexpr(vector_like<container_t>::value) {
-        auto r = xore<SDRElem_t, container_t>(std::make_move_iterator(me.v.begin()), std::make_move_iterator(me.v.end()), arg_begin, arg_end);
+        auto r = xore<SDRElem_t, container_t>(std::make_move_iterator(me.v.begin()), std::make_move_iterator(me.v.end()), arg_begin, arg_end, me.template make_empty<SDR<SDRElem_t, container_t>>());
         me = std::move(r);
     } else if constexpr(flist_like<container_t>::value) {
         auto lagger = me.before_begin();
@@ -1411,19 +1731,45 @@ SDR<SDRElem_t, container_t>& xori(SDR<SDRElem_t, container_t>& me, QueryIterator
 template<typename SDRElem_t, typename container_t>
 template<typename arg_t, typename c_arg_t>
 SDR<SDRElem_t, container_t>& SDR<SDRElem_t, container_t>::xori(const SDR<arg_t, c_arg_t>& arg) {
-    return sparse_distributed_representation::xori(*this, arg.cbegin(), arg.cend());
+    if constexpr(word_wise<c_arg_t>) {
+        v.assign_words(v, arg.v, std::bit_xor<>());
+        return *this;
+    } else if constexpr(run_wise<c_arg_t>) {
+        v.assign_runs(v, arg.v, std::bit_xor<>());
+        return *this;
+    } else if constexpr(uses_compressed_like) {
+        // compressed containers can only append
+        *this = xore(arg);
+        return *this;
+    } else {
+        return sparse_distributed_representation::xori(*this, arg.cbegin(), arg.cend());
+    }
 }
 
 // exposing rval overload from iterator forms
 template<typename SDRElem_t, typename container_t>
 template<typename arg_t, typename c_arg_t>
 SDR<SDRElem_t, container_t>& SDR<SDRElem_t, container_t>::xori(SDR<arg_t, c_arg_t>&& arg) {
-    return sparse_distributed_representation::xori(*this, std::make_move_iterator(arg.v.begin()), std::make_move_iterator(arg.v.end()));
+    if constexpr(word_wise<c_arg_t>) {
+        v.assign_words(v, arg.v, std::bit_xor<>());
+        return *this;
+    } else if constexpr(run_wise<c_arg_t>) {
+        v.assign_runs(v, arg.v, std::bit_xor<>());
+        return *this;
+    } else if constexpr(uses_compressed_like) {
+        *this = xore(std::move(arg));
+        return *this;
+    } else {
+        return sparse_distributed_representation::xori(*this, std::make_move_iterator(arg.v.begin()), std::make_move_iterator(arg.v.end()));
+    }
 }
 
 template<typename SDRElem_t, typename container_t>
 template<typename arg_t, typename c_arg_t>
 typename SDR<SDRElem_t, container_t>::size_type SDR<SDRElem_t, container_t>::xors(const SDR<arg_t, c_arg_t>& arg) const {
+    if constexpr(word_wise<c_arg_t>) return v.count_words(arg.v, std::bit_xor<>());
+    if constexpr(run_wise<c_arg_t>) return v.count_runs(arg.v, std::bit_xor<>());
+    if constexpr(chunk_wise<c_arg_t>) return size() + arg.size() - 2 * v.and_count(arg.v);
     size_type remove = 0;
     auto visitor = [&](iterator this_pos, typename c_arg_t::iterator arg_pos) {
         if (!this_pos->data().xors(arg_pos->data())) ++remove;
@@ -1433,9 +1779,54 @@ typename SDR<SDRElem_t, container_t>::size_type SDR<SDRElem_t, container_t>::xor
     return this->size() + arg.size() - remove;
 }
 
+template<typename SDRElem_t, typename container_t>
+template<typename arg_t, typename c_arg_t>
+typename SDR<SDRElem_t, container_t>::size_type SDR<SDRElem_t, container_t>::xors_bounded(const SDR<arg_t, c_arg_t>& arg, size_type limit) const {
+    size_type this_remaining = size();
+    size_type arg_remaining = arg.size();
+    auto bound = [&](size_type distance) {
+        return distance + (this_remaining > arg_remaining ? this_remaining - arg_remaining : arg_remaining - this_remaining);
+    };
+    if (bound(0) > limit) return limit + 1;
+    // these count the whole xor faster than it can be walked
+    if constexpr(word_wise<c_arg_t> || run_wise<c_arg_t> || chunk_wise<c_arg_t>) return xors(arg);
+    size_type distance = 0;
+    auto this_pos = cbegin();
+    auto this_end = cend();
+    auto arg_pos = arg.cbegin();
+    auto arg_end = arg.cend();
+    while (this_pos != this_end && arg_pos != arg_end) {
+        if (this_pos->id() < arg_pos->id()) {
+            ++distance;
+            ++this_pos;
+            --this_remaining;
+        } else if (arg_pos->id() < this_pos->id()) {
+            ++distance;
+            ++arg_pos;
+            --arg_remaining;
+        } else {
+            // same as xors, the combined element is only counted if it's relevant
+            if (this_pos->data().xors(arg_pos->data())) ++distance;
+            ++this_pos;
+            ++arg_pos;
+            --this_remaining;
+            --arg_remaining;
+        }
+        if (bound(distance) > limit) return limit + 1;
+    }
+    return distance + this_remaining + arg_remaining;
+}
+
 template<typename SDRElem_t, typename container_t>
 template<typename arg_t, typename c_arg_t>
 SDR<SDRElem_t, container_t>& SDR<SDRElem_t, container_t>::rmi(const SDR<arg_t, c_arg_t>& arg) {
+    if constexpr(word_wise<c_arg_t>) {
+        v.assign_words(v, arg.v, bit_rm());
+        return *this;
+    } else if constexpr(run_wise<c_arg_t>) {
+        v.assign_runs(v, arg.v, bit_rm());
+        return *this;
+    }
     auto rmi_combine = [](iterator this_pos, typename c_arg_t::iterator arg_pos) {
         typename SDRElem_t::data_type& this_data = const_cast<typename SDRElem_t::data_type&>(this_pos->data()); // cast for std::set
         const typename arg_t::data_type& arg_data = arg_pos->data();
@@ -1447,7 +1838,11 @@ SDR<SDRElem_t, container_t>& SDR<SDRElem_t, container_t>::rmi(const SDR<arg_t, c
 template<typename SDRElem_t, typename container_t>
 template<typename arg_t, typename c_arg_t, typename rmi_combiner>
 SDR<SDRElem_t, container_t>& SDR<SDRElem_t, container_t>::rmi(const SDR<arg_t, c_arg_t>& arg, rmi_combiner rmi_combine) {
-    if constexpr(uses_vector_like) {
+    if constexpr(chunk_wise<c_arg_t> || uses_compressed_like) {
+        // the chunk-wise andv doesn't allow erasing from within the visitor, and compressed containers can't erase.
+        // neither store data, so there's nothing to combine
+        *this = rme(arg);
+    } else if constexpr(uses_vector_like) {
         // this_fill emulates an orv over this but an andv over the arg
         const_iterator this_fill = this->cbegin();
         iterator insert_pos = this->v.begin();
@@ -1515,7 +1910,9 @@ SDR<SDRElem_t, container_t>& SDR<SDRElem_t, container_t>::rmi(const SDR<arg_t, c
 template<typename SDRElem_t, typename container_t>
 template<typename ret_t, typename c_ret_t, typename arg_t, typename c_arg_t>
 SDR<ret_t, c_ret_t> SDR<SDRElem_t, container_t>::rme(const SDR<arg_t, c_arg_t>& arg) const {
-    SDR<ret_t, c_ret_t> r;
+    if constexpr(word_wise<c_arg_t>) return word_wise_op<ret_t, c_ret_t>(arg, bit_rm());
+    if constexpr(run_wise<c_arg_t>) return run_wise_op<ret_t, c_ret_t>(arg, bit_rm());
+    SDR<ret_t, c_ret_t> r = make_empty<SDR<ret_t, c_ret_t>>();
     // this_fill emulates an orv over this but an andv over the arg
     const_iterator this_fill = this->cbegin();
     [[maybe_unused]] typename c_ret_t::const_iterator it; // iterator for appending to flist result
@@ -1568,6 +1965,9 @@ SDR<ret_t, c_ret_t> SDR<SDRElem_t, container_t>::rme(const SDR<arg_t, c_arg_t>&
 template<typename SDRElem_t, typename container_t>
 template<typename arg_t, typename c_arg_t>
 typename SDR<SDRElem_t, container_t>::size_type SDR<SDRElem_t, container_t>::rms(const SDR<arg_t, c_arg_t>& arg) const {
+    if constexpr(word_wise<c_arg_t>) return v.count_words(arg.v, bit_rm());
+    if constexpr(run_wise<c_arg_t>) return v.count_runs(arg.v, bit_rm());
+    if constexpr(chunk_wise<c_arg_t>) return size() - v.and_count(arg.v);
     size_type remove = 0;
     auto visitor = [&](iterator this_pos, typename c_arg_t::iterator arg_pos) {
         if (!this_pos->data().rms(arg_pos->data())) ++remove;
@@ -1576,6 +1976,33 @@ typename SDR<SDRElem_t, container_t>::size_type SDR<SDRElem_t, container_t>::rms
     return this->size() - remove;
 }
 
+template<typename SDRElem_t, typename container_t>
+template<typename arg_t, typename c_arg_t>
+OverlapStats<typename SDR<SDRElem_t, container_t>::size_type> SDR<SDRElem_t, container_t>::overlap_stats(const SDR<arg_t, c_arg_t>& arg) const {
+    size_type this_size = this->size();
+    size_type arg_size = arg.size();
+    if constexpr(std::is_same_v<typename SDRElem_t::data_type, EmptyData> && std::is_same_v<typename arg_t::data_type, EmptyData>) {
+        // the data doesn't affect the result, so every size follows from the overlap.
+        // ands uses the fastest way to count it for these containers (word-wise, simd, etc.)
+        size_type overlap = ands(arg);
+        return {this_size, arg_size, overlap, this_size + arg_size - overlap, this_size + arg_size - 2 * overlap, this_size - overlap};
+    } else {
+        // same checks as ands, xors, and rms
+        size_type overlap = 0;
+        size_type and_count = 0;
+        size_type xor_remove = 0;
+        size_type rm_remove = 0;
+        auto visitor = [&](iterator this_pos, typename c_arg_t::iterator arg_pos) {
+            ++overlap;
+            if (this_pos->data().ands(arg_pos->data())) ++and_count;
+            if (!this_pos->data().xors(arg_pos->data())) ++xor_remove;
+            if (!this_pos->data().rms(arg_pos->data())) ++rm_remove;
+        };
+        const_cast<SDR&>(*this).andv(const_cast<SDR<arg_t, c_arg_t>&>(arg), visitor);
+        return {this_size, arg_size, and_count, this_size + arg_size - overlap, this_size + arg_size - overlap - xor_remove, this_size - rm_remove};
+    }
+}
+
 template<typename SDRElem_t, typename container_t>
 SDR<SDRElem_t, container_t>& SDR<SDRElem_t, container_t>::shift(int amount) {
     for (auto& elem : v) {
@@ -1597,10 +2024,8 @@ SDR<SDRElem_t, container_t>& SDR<SDRElem_t, container_t>::append(SDR<arg_t, c_ar
     if constexpr(uses_vector_like) {
         auto old_size = this->v.size();
         this->v.resize(this->v.size() + arg.v.size());
-        auto insert_it = this->v.begin() + old_size;
-        for (auto it = arg.v.begin(); it != arg.v.end(); ++it) {
-            *insert_it++ = std::move(*it);
-        }
+        // this is a memmove if the elements are trivially copyable
+        std::move(arg.v.begin(), arg.v.end(), this->v.begin() + old_size);
     } else {
         auto pos = arg.begin();
         auto end = arg.end();
@@ -1694,13 +2119,13 @@ ret_t SDR<SDRElem_t, container_t>::inner(const SDR<arg_t, c_arg_t>& other) const
 template<typename SDRElem_t, typename container_t>
 template< typename arg_t, typename c_arg_t, typename ret_t, typename c_ret_t>
 SDR<ret_t, c_ret_t> SDR<SDRElem_t, container_t>::outer(const SDR<arg_t, c_arg_t>& other) const {
-    SDR<ret_t, c_ret_t> ret;
+    SDR<ret_t, c_ret_t> ret = make_empty<SDR<ret_t, c_ret_t>>();
     [[maybe_unused]] typename c_ret_t::iterator it;
     if constexpr(flist_like<c_ret_t>::value) {
         it = ret.v.before_begin();
     }
     for (const auto& elem : *this) {
-        typename ret_t::data_type data;
+        typename ret_t::data_type data = ret.template make_empty<typename ret_t::data_type>();
         [[maybe_unused]] typename ret_t::data_type::container_type::iterator inner_it;
         if constexpr(flist_like<typename ret_t::data_type::container_type>::value) {
             inner_it = data.v.before_begin();
@@ -1709,7 +2134,7 @@ SDR<ret_t, c_ret_t> SDR<SDRElem_t, container_t>::outer(const SDR<arg_t, c_arg_t>
             auto val_data = elem.data().template ande<typename ret_t::data_type::value_type::data_type>(other_elem.data());
             typename ret_t::data_type::value_type val(other_elem.id(), std::move(val_data));
             if constexpr(flist_like<typename ret_t::data_type::container_type>::value) {
-                ++ret.maybe_size.size;
+                ++data.maybe_size.size;
                 inner_it = data.v.insert_after(inner_it, std::move(val));
             } else {
                 data.push_back(std::move(val));
@@ -1729,7 +2154,7 @@ SDR<ret_t, c_ret_t> SDR<SDRElem_t, container_t>::outer(const SDR<arg_t, c_arg_t>
 template<typename SDRElem_t, typename container_t>
 template<typename arg_t, typename c_arg_t, typename ret_t, typename c_ret_t>
 SDR<ret_t, c_ret_t> SDR<SDRElem_t, container_t>::row_major_mul_vec(const SDR<arg_t, c_arg_t>& arg) const {
-    SDR<ret_t, c_ret_t> ret;
+    SDR<ret_t, c_ret_t> ret = make_empty<SDR<ret_t, c_ret_t>>();
     [[maybe_unused]] typename c_ret_t::iterator it;
     if constexpr(flist_like<c_ret_t>::value) {
         it = ret.v.before_begin();
@@ -1752,7 +2177,7 @@ SDR<ret_t, c_ret_t> SDR<SDRElem_t, container_t>::row_major_mul_vec(const SDR<arg
 template<typename SDRElem_t, typename container_t>
 template<typename arg_t, typename c_arg_t, typename ret_t, typename c_ret_t, typename priority_queue_t>
 SDR<ret_t, c_ret_t> SDR<SDRElem_t, container_t>::col_major_mul_vec(const SDR<arg_t, c_arg_t>& arg) const {
-    SDR<ret_t, c_ret_t> ret;
+    SDR<ret_t, c_ret_t> ret = make_empty<SDR<ret_t, c_ret_t>>();
     matrix_utils::OtherMajorView<priority_queue_t> view;
 
     auto both_visitor = [&](iterator this_pos, typename c_arg_t::iterator) {
@@ -1793,7 +2218,9 @@ struct is_vector<std::vector<T, A>> : std::true_type {};
 
 template<typename priority_queue_t, typename obj_with_size>
 auto preallocate_priority_queue_container([[maybe_unused]] const obj_with_size& obj) {
-    if constexpr(is_vector<typename priority_queue_t::container_type>::value) {
+    if constexpr(matrix_utils::advances_in_place<priority_queue_t>::value) {
+        return priority_queue_t();
+    } else if constexpr(is_vector<typename priority_queue_t::container_type>::value) {
         typename priority_queue_t::container_type v;
         v.reserve(obj.size());
         return priority_queue_t(typename priority_queue_t::value_compare(), std::move(v));
@@ -1807,7 +2234,50 @@ auto preallocate_priority_queue_container([[maybe_unused]] const obj_with_size&
 template<typename SDRElem_t, typename container_t>
 template<typename ret_t, typename c_ret_t, typename priority_queue_t>
 SDR<ret_t, c_ret_t> SDR<SDRElem_t, container_t>::transpose() const {
-    SDR<ret_t, c_ret_t> ret;
+    SDR<ret_t, c_ret_t> ret = make_empty<SDR<ret_t, c_ret_t>>();
+
+    using minor_id_t = typename SDRElem_t::data_type::value_type::id_type;
+    if constexpr(is_vector<c_ret_t>::value && is_vector<typename ret_t::data_type::container_type>::value && std::is_integral_v<minor_id_t>
+                 && !matrix_utils::advances_in_place<priority_queue_t>::value) {
+        // counting sort, if the minor ids are in a range that's not much larger than the number of elements
+        size_type nnz = 0;
+        minor_id_t lo = minor_id_t();
+        minor_id_t hi = minor_id_t();
+        for (const auto& row : *this) {
+            for (const auto& elem : row.data()) {
+                if (nnz == 0 || elem.id() < lo) lo = elem.id();
+                if (nnz == 0 || elem.id() > hi) hi = elem.id();
+                ++nnz;
+            }
+        }
+        if (nnz == 0) return ret;
+        std::size_t range = matrix_utils::dense_id_range(lo, hi, nnz);
+        if (range != 0) {
+            // the number of elements in each output row, which is then replaced by the output row's index
+            std::vector<size_type> slots(range, 0);
+            for (const auto& row : *this) {
+                for (const auto& elem : row.data()) {
+                    ++slots[matrix_utils::id_offset<minor_id_t>(elem.id(), lo)];
+                }
+            }
+            size_type rows = static_cast<size_type>(range - static_cast<std::size_t>(std::count(slots.cbegin(), slots.cend(), 0)));
+            ret.reserve(rows);
+            for (std::size_t i = 0; i < range; ++i) {
+                if (slots[i] == 0) continue;
+                typename ret_t::data_type output_row = ret.template make_empty<typename ret_t::data_type>();
+                output_row.reserve(slots[i]);
+                ret.push_back(ret_t(static_cast<typename ret_t::id_type>(matrix_utils::id_at_offset(lo, i)), std::move(output_row)));
+                slots[i] = ret.size() - 1;
+            }
+            // the input rows are visited in ascending order, so each output row is filled in ascending order
+            for (const auto& row : *this) {
+                for (const auto& elem : row.data()) {
+                    ret[slots[matrix_utils::id_offset<minor_id_t>(elem.id(), lo)]].data().push_back(typename ret_t::data_type::value_type(row.id(), elem.data()));
+                }
+            }
+            return ret;
+        }
+    }
 
     auto q = preallocate_priority_queue_container<priority_queue_t>(*this);
     matrix_utils::OtherMajorView<priority_queue_t> view(std::move(q));
@@ -1826,9 +2296,9 @@ SDR<ret_t, c_ret_t> SDR<SDRElem_t, container_t>::transpose() const {
 }
 
 template<typename SDRElem_t, typename container_t>
-template<typename arg_t, typename c_arg_t, typename ret_t, typename c_ret_t, typename priority_queue_t>
+template<typename arg_t, typename c_arg_t, typename ret_t, typename c_ret_t, typename priority_queue_t, typename accumulator_t>
 SDR<ret_t, c_ret_t> SDR<SDRElem_t, container_t>::same_mul(const SDR<arg_t, c_arg_t>& arg) const {
-    SDR<ret_t, c_ret_t> ret;
+    SDR<ret_t, c_ret_t> ret = make_empty<SDR<ret_t, c_ret_t>>();
     // for variable naming, assume that both this and the arg are row major
 
     [[maybe_unused]] typename c_ret_t::const_iterator output_row_insertion;
@@ -1836,6 +2306,24 @@ SDR<ret_t, c_ret_t> SDR<SDRElem_t, container_t>::same_mul(const SDR<arg_t, c_arg
         output_row_insertion = ret.before_begin();
     } 
 
+    if constexpr(!std::is_void_v<accumulator_t>) {
+        matrix_utils::GustavsonRow<accumulator_t, typename SDRElem_t::data_type::value_type, arg_t> multiply;
+        for (const auto& row : *this) {
+            typename ret_t::data_type output_data = ret.template make_empty<typename ret_t::data_type>();
+            multiply(row.data(), arg, output_data);
+
+            if (output_data.relevant()) {
+                ret_t output(row.id(), std::move(output_data));
+                if constexpr(flist_like<c_ret_t>::value) {
+                    output_row_insertion = ret.insert_after(output_row_insertion, std::move(output));
+                } else {
+                    ret.push_back(std::move(output));
+                }
+            }
+        }
+        return ret;
+    }
+
     for (const auto& row : *this) {
         typename SDRElem_t::data_type::const_iterator this_row_retrival = row.data().cbegin();
 
@@ -1845,7 +2333,7 @@ SDR<ret_t, c_ret_t> SDR<SDRElem_t, container_t>::same_mul(const SDR<arg_t, c_arg
         };
         const_cast<typename SDRElem_t::data_type&>(row.data()).andv(const_cast<SDR<arg_t, c_arg_t>&>(arg), both_visitor);
 
-        typename ret_t::data_type output_data;
+        typename ret_t::data_type output_data = ret.template make_empty<typename ret_t::data_type>();
 
         { // scope for accumulator dtor
             matrix_utils::BucketOutputAccumulator accumulator(output_data);
@@ -1874,7 +2362,7 @@ SDR<ret_t, c_ret_t> SDR<SDRElem_t, container_t>::same_mul(const SDR<arg_t, c_arg
         if (output_data.relevant()) {
             ret_t output(row.id(), std::move(output_data));
             if constexpr(flist_like<c_ret_t>::value) {
-                output_row_insertion = ret.v.insert_after(output_row_insertion, std::move(output));
+                output_row_insertion = ret.insert_after(output_row_insertion, std::move(output));
             } else {
                 ret.push_back(std::move(output));
             }
@@ -1886,13 +2374,13 @@ SDR<ret_t, c_ret_t> SDR<SDRElem_t, container_t>::same_mul(const SDR<arg_t, c_arg
 template<typename SDRElem_t, typename container_t>
 template<typename arg_t, typename c_arg_t, typename ret_t, typename c_ret_t>
 SDR<ret_t, c_ret_t> SDR<SDRElem_t, container_t>::diff_mul(const SDR<arg_t, c_arg_t>& arg) const {
-    SDR<ret_t, c_ret_t> ret;
+    SDR<ret_t, c_ret_t> ret = make_empty<SDR<ret_t, c_ret_t>>();
     [[maybe_unused]] typename c_ret_t::iterator it;
     if constexpr(flist_like<c_ret_t>::value) {
         it = ret.v.before_begin();
     }
     for (const auto& row : *this) {
-        typename ret_t::data_type row_data;
+        typename ret_t::data_type row_data = ret.template make_empty<typename ret_t::data_type>();
         [[maybe_unused]] typename ret_t::data_type::const_iterator inner_it;
         if constexpr(flist_like<typename ret_t::data_type::container_type>::value) {
             inner_it = row_data.before_begin();
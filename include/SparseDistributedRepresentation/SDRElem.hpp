@@ -24,25 +24,16 @@ class SDRElem {
         explicit SDRElem(id_t id) : id_(id), data_() {}
         SDRElem() : id_(), data_() {}
 
-        SDRElem(const SDRElem& o) : id_(o.id()), data_(o.data()) {}
+        // the copy and move operations are defaulted, so the element is trivially copyable if the id and data are.
+        // that way containers of elements (e.g. std::vector<SDRElem<int>>) are copied and moved with memmove
+        SDRElem(const SDRElem& o) = default;
+        SDRElem(SDRElem&& o) = default;
+        SDRElem& operator=(const SDRElem& o) = default;
+        SDRElem& operator=(SDRElem&& o) = default;
 
         template<typename o_id_t, typename o_data_t>
         explicit SDRElem(const SDRElem<o_id_t, o_data_t>& o) : id_(o.id()), data_(o.data()) {}
 
-        SDRElem& operator=(const SDRElem& o) {
-            const_cast<id_t&>(id_) = o.id();
-            data_ = o.data();
-            return *this;
-        }
-
-        SDRElem(SDRElem&& o) noexcept : id_(std::move(o.id())), data_(std::move(o.data())) {}
-
-        SDRElem& operator=(SDRElem&& o) noexcept {
-            const_cast<id_t&>(id_) = o.id();
-            data_ = std::move(o.data());
-            return *this;
-        }
-
         const id_t& id() const { return id_; }
         data_t& data() { return data_; }
         const data_t& data() const { return data_; }
@@ -75,7 +66,9 @@ class SDRElem {
         bool operator>(id_t o) const { return id() > o; }
     
     private:
-        const id_t id_;
+        // the id can't be set after construction (there is only a const getter), but it is not const.
+        // a const member would prevent the default assignment operators
+        id_t id_;
         data_t data_;
 };
 
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace sparse_distributed_representation {
+
+// helpers for taking a range (e.g. a std::vector) of SDRs, or pointers to SDRs, or std::reference_wrappers of SDRs,
+// and for building an SDR in ascending order. shared by the n-ary ops and the other ops over many SDRs.
+
+namespace nary_ops {
+
+template<typename T>
+const T& deref(const T& sdr) { return sdr; }
+
+template<typename T>
+const T& deref(T* sdr) { return *sdr; }
+
+template<typename T>
+const T& deref(std::reference_wrapper<T> sdr) { return sdr.get(); }
+
+// the SDR type in the range
+template<typename Range>
+using sdr_type = std::remove_cv_t<std::remove_reference_t<decltype(deref(*std::begin(std::declval<const Range&>())))>>;
+
+// appends to an SDR which is being built in ascending order
+template<typename ret_sdr_t>
+class Appender {
+    public:
+        Appender(ret_sdr_t& r) : r(r) {
+            if constexpr(ret_sdr_t::uses_flist_like) it = r.before_begin();
+        }
+
+        template<typename E>
+        void operator()(E&& elem) {
+            if constexpr(ret_sdr_t::uses_flist_like) {
+                it = r.insert_after(it, std::forward<E>(elem));
+            } else {
+                r.push_back(std::forward<E>(elem));
+            }
+        }
+
+    private:
+        ret_sdr_t& r;
+        [[maybe_unused]] typename ret_sdr_t::const_iterator it;
+};
+
+} // namespace nary_ops
+
+} // namespace sparse_distributed_representation
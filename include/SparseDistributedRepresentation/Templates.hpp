@@ -1,6 +1,10 @@
 #pragma once
 
+#include <cstddef>
+#include <iterator>
+#include <memory>
 #include <type_traits>
+#include <utility>
 
 namespace sparse_distributed_representation {
 
@@ -21,6 +25,7 @@ struct flist_like : std::true_type {};
 template<typename T>
 struct flist_like<T, decltype((void)T().size(), void())> : std::false_type {};
 
+// any container with random access iterators (e.g. std::vector, InlineContainer)
 template<typename T>
 struct vector_like : std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<typename T::iterator>::iterator_category> {};
 
@@ -30,6 +35,63 @@ struct set_like : std::false_type {};
 template<typename T>
 struct set_like<T, decltype((void)T().lower_bound(typename T::value_type()), void())> : std::true_type {};
 
+// the container stores the elements as words of bits (e.g. BitsetContainer), which allows for word-wise ops
+template<typename T, typename = void>
+struct bitset_like : std::false_type {};
+
+template<typename T>
+struct bitset_like<T, decltype((void)T().words(), void())> : std::true_type {};
+
+// both containers are bitsets over the same universe, so their words line up
+template<typename A, typename B, typename = void>
+struct same_universe : std::false_type {};
+
+template<typename A, typename B>
+struct same_universe<A, B, std::enable_if_t<bitset_like<A>::value && bitset_like<B>::value>>
+    : std::bool_constant<A::universe_size == B::universe_size> {};
+
+// the container partitions the elements into chunks (e.g. RoaringContainer), which allows for chunk against chunk ops
+template<typename T, typename = void>
+struct chunked_like : std::false_type {};
+
+template<typename T>
+struct chunked_like<T, decltype((void)T().chunks(), void())> : std::true_type {};
+
+// the container stores the elements encoded, such that they can only be appended and are decoded in order (e.g. CompressedContainer)
+template<typename T, typename = void>
+struct compressed_like : std::false_type {};
+
+template<typename T>
+struct compressed_like<T, decltype((void)T().encoded(), void())> : std::true_type {};
+
+// the container stores the elements as runs of consecutive ids (e.g. RunContainer), which allows for run-wise ops
+template<typename T, typename = void>
+struct run_like : std::false_type {};
+
+template<typename T>
+struct run_like<T, decltype((void)T().runs(), void())> : std::true_type {};
+
+// the container can take the elements of another of the same type (e.g. std::set::merge)
+template<typename T, typename = void>
+struct has_merge : std::false_type {};
+
+template<typename T>
+struct has_merge<T, decltype((void)std::declval<T&>().merge(std::declval<T&>()), void())> : std::true_type {};
+
+// the container has an allocator (e.g. std::pmr::vector)
+template<typename T, typename = void>
+struct allocator_aware : std::false_type {};
+
+template<typename T>
+struct allocator_aware<T, decltype((void)std::declval<const T&>().get_allocator(), void())> : std::true_type {};
+
+// a container of type to_t can be constructed with the allocator from a container of type from_t
+template<typename from_t, typename to_t, typename = void>
+struct shares_allocator : std::false_type {};
+
+template<typename from_t, typename to_t>
+struct shares_allocator<from_t, to_t, std::enable_if_t<allocator_aware<from_t>::value>> : std::uses_allocator<to_t, typename from_t::allocator_type> {};
+
 template<typename T, typename = void>
 struct set_comparator_check : std::false_type {};
 
@@ -68,6 +130,14 @@ struct replace_type_in_params___<old_t, new_t, T<arg_element, arg_p...>> {
     using type = T<replace_type<old_t, new_t, arg_element>, replace_type_in_params___<old_t, new_t, T<arg_p...>>>;
 };
 
+template<typename old_t,
+    typename new_t,
+    template <typename, std::size_t> class T, typename arg_element, std::size_t N>
+struct replace_type_in_params___<old_t, new_t, T<arg_element, N>> {
+    // a container with a size parameter (e.g. InlineContainer<elem, N>)
+    using type = T<replace_type<old_t, new_t, arg_element>, N>;
+};
+
 // declares a container, but it instead stores new_item_t
 template<typename container_t, typename new_item_t>
 using replace_value_type = replace_type<typename container_t::value_type, new_item_t, container_t>;
@@ -2,6 +2,11 @@
 #include "SparseDistributedRepresentation/DataTypes/UnitData.hpp"
 #include "SparseDistributedRepresentation/DataTypes/ArithData.hpp"
 #include "SparseDistributedRepresentation/IDContiguousContainer.hpp"
+#include "SparseDistributedRepresentation/BitsetContainer.hpp"
+#include "SparseDistributedRepresentation/RoaringContainer.hpp"
+#include "SparseDistributedRepresentation/CompressedContainer.hpp"
+#include "SparseDistributedRepresentation/RunContainer.hpp"
+#include "SparseDistributedRepresentation/InlineContainer.hpp"
 #include <cstring>
 #include <chrono>
 #include <unistd.h>
@@ -222,6 +227,14 @@ template<typename SDR>
 std::string get_template_name() {
     if constexpr(SDR::uses_vector_like) {
         return "vec";
+    } else if constexpr(SDR::uses_bitset_like) {
+        return "bit";
+    } else if constexpr(SDR::uses_chunked_like) {
+        return "roa";
+    } else if constexpr(SDR::uses_compressed_like) {
+        return "cmp";
+    } else if constexpr(SDR::uses_run_like) {
+        return "run";
     } else if constexpr(SDR::uses_set_like) {
         return "set";
     } else if constexpr(SDR::uses_flist_like) {
@@ -408,6 +421,35 @@ int main(int argc, char** argv) {
 
     #ifdef FUZZ_FULL
 
+    std::cout << "======Bitset======" << std::endl;
+
+    series<SDR<SDRElem<>, BitsetContainer<SDRElem<>, 64>>, SDR<SDRElem<>, BitsetContainer<SDRElem<>, 64>>>(fuzz_amount);
+    series<SDR<SDRElem<>, BitsetContainer<SDRElem<>, 64>>, SDR<SDRElem<>, std::vector<SDRElem<>>>>(fuzz_amount);
+    series<SDR<SDRElem<>, std::vector<SDRElem<>>>, SDR<SDRElem<>, BitsetContainer<SDRElem<>, 64>>>(fuzz_amount);
+
+    std::cout << "======Roaring======" << std::endl;
+
+    series<SDR<SDRElem<>, RoaringContainer<SDRElem<>>>, SDR<SDRElem<>, RoaringContainer<SDRElem<>>>>(fuzz_amount);
+    series<SDR<SDRElem<>, RoaringContainer<SDRElem<>>>, SDR<SDRElem<>, std::vector<SDRElem<>>>>(fuzz_amount);
+    series<SDR<SDRElem<>, std::vector<SDRElem<>>>, SDR<SDRElem<>, RoaringContainer<SDRElem<>>>>(fuzz_amount);
+
+    std::cout << "======Compressed======" << std::endl;
+
+    series<SDR<SDRElem<>, CompressedContainer<SDRElem<>>>, SDR<SDRElem<>, CompressedContainer<SDRElem<>>>>(fuzz_amount);
+    series<SDR<SDRElem<>, CompressedContainer<SDRElem<>>>, SDR<SDRElem<>, std::vector<SDRElem<>>>>(fuzz_amount);
+    series<SDR<SDRElem<>, std::vector<SDRElem<>>>, SDR<SDRElem<>, CompressedContainer<SDRElem<>>>>(fuzz_amount);
+
+    std::cout << "======Run======" << std::endl;
+
+    series<SDR<SDRElem<>, RunContainer<SDRElem<>>>, SDR<SDRElem<>, RunContainer<SDRElem<>>>>(fuzz_amount);
+    series<SDR<SDRElem<>, RunContainer<SDRElem<>>>, SDR<SDRElem<>, std::vector<SDRElem<>>>>(fuzz_amount);
+    series<SDR<SDRElem<>, std::vector<SDRElem<>>>, SDR<SDRElem<>, RunContainer<SDRElem<>>>>(fuzz_amount);
+
+    std::cout << "======Inline======" << std::endl;
+
+    series<SDR<SDRElem<>, InlineContainer<SDRElem<>, 40>>, SDR<SDRElem<>, InlineContainer<SDRElem<>, 40>>>(fuzz_amount);
+    series<SDR<SDRElem<>, InlineContainer<SDRElem<>, 40>>, SDR<SDRElem<>, std::set<SDRElem<>, std::less<>>>>(fuzz_amount);
+
     std::cout << "======With data elements======" << std::endl;
 
     series<SDR<SDRElem<long, UnitData>, std::vector<SDRElem<long, UnitData>>>, SDR<SDRElem<int, UnitData>, std::vector<SDRElem<int, UnitData>>>>(fuzz_amount);
@@ -3,6 +3,21 @@
 #include <boost/test/output_test_stream.hpp>
 #include "SparseDistributedRepresentation/SDR.hpp"
 #include "SparseDistributedRepresentation/IDContiguousContainer.hpp"
+#include "SparseDistributedRepresentation/BitsetContainer.hpp"
+#include "SparseDistributedRepresentation/RoaringContainer.hpp"
+#include "SparseDistributedRepresentation/CompressedContainer.hpp"
+#include "SparseDistributedRepresentation/RunContainer.hpp"
+#include "SparseDistributedRepresentation/InlineContainer.hpp"
+#include "SparseDistributedRepresentation/NAryOps.hpp"
+#include "SparseDistributedRepresentation/InvertedIndex.hpp"
+#include "SparseDistributedRepresentation/MinHash.hpp"
+#include "SparseDistributedRepresentation/PairwiseOverlap.hpp"
+#include "SparseDistributedRepresentation/HammingSearch.hpp"
+#include "SparseDistributedRepresentation/Fingerprint.hpp"
+#include "SparseDistributedRepresentation/InternPool.hpp"
+#include "SparseDistributedRepresentation/OpCache.hpp"
+#include "SparseDistributedRepresentation/CompressedMatrix.hpp"
+#include "SparseDistributedRepresentation/ParallelMatrix.hpp"
 #include "SparseDistributedRepresentation/DataTypes/ArithData.hpp"
 #include "SparseDistributedRepresentation/DataTypes/UnitData.hpp"
 #include <random>
@@ -10,6 +25,11 @@
 #include <alloca.h>
 #include <forward_list>
 #include <set>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <variant>
+#include <memory_resource>
 using namespace sparse_distributed_representation;
 
 BOOST_AUTO_TEST_SUITE(sdr)
@@ -37,6 +57,22 @@ BOOST_AUTO_TEST_CASE(move_assign_ctor) {
   BOOST_REQUIRE_EQUAL(b, (SDR{1, 2, 3}));
 }
 
+BOOST_AUTO_TEST_CASE(trivially_copyable_elem) {
+  static_assert(std::is_trivially_copyable_v<SDRElem<>>);
+  static_assert(std::is_trivially_copyable_v<SDRElem<long, UnitData>>);
+  static_assert(std::is_trivially_copyable_v<SDRElem<unsigned, ArithData<>>>);
+  static_assert(!std::is_trivially_copyable_v<SDRElem<int, SDR<>>>);
+  // the id can only be set on construction or by assigning a whole element
+  SDRElem<int, UnitData> a(1, 0.5);
+  SDRElem<int, UnitData> b(2, 0.25);
+  a = b;
+  BOOST_REQUIRE_EQUAL(a.id(), 2);
+  BOOST_REQUIRE_EQUAL(a.data().value(), 0.25);
+  SDR<SDRElem<int, UnitData>> c{SDRElem<int, UnitData>(1, 0.5)};
+  c.append(SDR<SDRElem<int, UnitData>>{SDRElem<int, UnitData>(2, 0.5), SDRElem<int, UnitData>(3, 0.5)});
+  BOOST_REQUIRE_EQUAL(c, (SDR<SDRElem<int, UnitData>>{SDRElem<int, UnitData>(1, 0.5), SDRElem<int, UnitData>(2, 0.5), SDRElem<int, UnitData>(3, 0.5)}));
+}
+
 BOOST_AUTO_TEST_CASE(iter_ctor) {
   std::vector<SDRElem<>> v{SDRElem<>(1), SDRElem<>(2), SDRElem<>(3)};
   BOOST_REQUIRE_EQUAL(SDR(v.begin(), v.end()), (SDR{1, 2, 3}));
@@ -183,6 +219,924 @@ BOOST_AUTO_TEST_CASE(test_readme_visitor) {
   BOOST_REQUIRE_EQUAL(result, 2);
 }
 
+BOOST_AUTO_TEST_CASE(andv_gallop) {
+  // sizes are skewed enough that the smaller SDR is walked and the larger SDR is galloped through
+  SDR small{3, 500, 501, 998, 5000};
+  SDR large;
+  for (int i = 0; i < 1000; i += 2) {
+    large.push_back(i);
+  }
+  BOOST_REQUIRE_EQUAL(small.ande(large), (SDR{500, 998}));
+  BOOST_REQUIRE_EQUAL(large.ande(small), (SDR{500, 998}));
+  BOOST_REQUIRE_EQUAL(small.ands(large), 2);
+  BOOST_REQUIRE_EQUAL(large.rms(small), 498);
+  BOOST_REQUIRE_EQUAL(SDR{}.ands(large), 0);
+  BOOST_REQUIRE_EQUAL(large.ands(SDR{999}), 0);
+  BOOST_REQUIRE_EQUAL(large.ands(SDR{0}), 1);
+
+  using E = SDRElem<int, ArithData<>>;
+  SDR<E, IDContiguousContainer<E>> large_idc;
+  for (const auto& elem : large) {
+    large_idc.push_back(E(elem.id(), 1));
+  }
+  BOOST_REQUIRE_EQUAL(small.ande(large_idc), (SDR{500, 998}));
+  BOOST_REQUIRE_EQUAL(large_idc.ands(small), 2);
+}
+
+template<typename id_t>
+void check_intersect_kernels() {
+  std::mt19937 twister(1234);
+  using E = SDRElem<id_t>;
+  using UE = SDRElem<id_t, ArithData<>>;
+  for (int trial = 0; trial < 50; ++trial) {
+    SDR<E> a;
+    SDR<E> b;
+    SDR<UE, IDContiguousContainer<UE>> a_idc;
+    std::vector<id_t> a_ids;
+    std::vector<id_t> b_ids;
+    for (id_t i = 0; i < 300; ++i) {
+      if (twister() % 3 == 0) {
+        a.push_back(E(i));
+        a_idc.push_back(UE(i, 1));
+        a_ids.push_back(i);
+      }
+      if (twister() % 2 == 0) {
+        b.push_back(E(i));
+        b_ids.push_back(i);
+      }
+    }
+    std::vector<id_t> expected;
+    std::set_intersection(a_ids.begin(), a_ids.end(), b_ids.begin(), b_ids.end(), std::back_inserter(expected));
+    BOOST_REQUIRE_EQUAL(a.ands(b), expected.size());
+    BOOST_REQUIRE_EQUAL(a.ors(b), a.size() + b.size() - expected.size());
+    BOOST_REQUIRE_EQUAL(a.ande(b), SDR<E>(expected.begin(), expected.end()));
+    BOOST_REQUIRE_EQUAL(a.rms(b), a.size() - expected.size());
+    BOOST_REQUIRE_EQUAL(a_idc.ands(b), expected.size());
+    BOOST_REQUIRE_EQUAL(a_idc.ors(a_idc), a_idc.size());
+    SDR<E> a_cp(a);
+    a_cp.andi(b);
+    BOOST_REQUIRE_EQUAL(a_cp, SDR<E>(expected.begin(), expected.end()));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(intersect_kernels) {
+  check_intersect_kernels<int>();
+  check_intersect_kernels<unsigned int>();
+  check_intersect_kernels<long>();
+}
+
+BOOST_AUTO_TEST_CASE(bitset_container) {
+  using B = SDR<SDRElem<>, BitsetContainer<SDRElem<>, 2048>>;
+  std::mt19937 twister(4321);
+  for (int trial = 0; trial < 20; ++trial) {
+    B a;
+    B b;
+    SDR a_vec;
+    SDR b_vec;
+    for (int i = 0; i < 2048; ++i) {
+      if (twister() % 20 == 0) {
+        a.push_back(i);
+        a_vec.push_back(i);
+      }
+      if (twister() % 10 == 0) {
+        b.push_back(i);
+        b_vec.push_back(i);
+      }
+    }
+    BOOST_REQUIRE_EQUAL(a, a_vec);
+    BOOST_REQUIRE_EQUAL(a.size(), a_vec.size());
+    // word-wise
+    BOOST_REQUIRE_EQUAL(a.ande(b), a_vec.ande(b_vec));
+    BOOST_REQUIRE_EQUAL(a.ore(b), a_vec.ore(b_vec));
+    BOOST_REQUIRE_EQUAL(a.xore(b), a_vec.xore(b_vec));
+    BOOST_REQUIRE_EQUAL(a.rme(b), a_vec.rme(b_vec));
+    BOOST_REQUIRE_EQUAL(a.ands(b), a_vec.ands(b_vec));
+    BOOST_REQUIRE_EQUAL(a.ors(b), a_vec.ors(b_vec));
+    BOOST_REQUIRE_EQUAL(a.xors(b), a_vec.xors(b_vec));
+    BOOST_REQUIRE_EQUAL(a.rms(b), a_vec.rms(b_vec));
+    BOOST_REQUIRE_EQUAL(B(a).andi(b), a_vec.ande(b_vec));
+    BOOST_REQUIRE_EQUAL(B(a).ori(b), a_vec.ore(b_vec));
+    BOOST_REQUIRE_EQUAL(B(a).xori(b), a_vec.xore(b_vec));
+    BOOST_REQUIRE_EQUAL(B(a).rmi(b), a_vec.rme(b_vec));
+    // sparse extraction into a different container
+    BOOST_REQUIRE_EQUAL((a.ande<SDRElem<>, std::vector<SDRElem<>>>(b)), a_vec.ande(b_vec));
+    BOOST_REQUIRE_EQUAL((a.ore<SDRElem<>, std::forward_list<SDRElem<>>>(b)), a_vec.ore(b_vec));
+    BOOST_REQUIRE_EQUAL((a.ore<SDRElem<>, std::forward_list<SDRElem<>>>(b)).size(), a_vec.ors(b_vec));
+    // mixed with other containers
+    BOOST_REQUIRE_EQUAL(a.ande(b_vec), a_vec.ande(b_vec));
+    BOOST_REQUIRE_EQUAL(a_vec.ande(b), a_vec.ande(b_vec));
+    BOOST_REQUIRE_EQUAL(a.ore(b_vec), a_vec.ore(b_vec));
+    BOOST_REQUIRE_EQUAL(B(a).rmi(b_vec), a_vec.rme(b_vec));
+  }
+  B c{1, 64, 2047};
+  BOOST_REQUIRE_NE(c & 64, nullptr);
+  BOOST_REQUIRE_EQUAL(c & 63, nullptr);
+  BOOST_REQUIRE_EQUAL(c.ande(2, 2047), (SDR{64}));
+  BOOST_REQUIRE_EQUAL(*--c.end(), SDRElem<>(2047));
+  c.erase(c.lower_bound(SDRElem<>(64)));
+  BOOST_REQUIRE_EQUAL(c, (SDR{1, 2047}));
+  BOOST_REQUIRE_EQUAL(c.size(), 2);
+  // different universes (but the same number of words) aren't word-wise
+  using Small = SDR<SDRElem<>, BitsetContainer<SDRElem<>, 100>>;
+  using Large = SDR<SDRElem<>, BitsetContainer<SDRElem<>, 120>>;
+  Small small{5, 99};
+  Large large{5, 110};
+  BOOST_REQUIRE_EQUAL(small.ande(large), (SDR{5}));
+  BOOST_REQUIRE_EQUAL(small.ands(large), 1);
+  BOOST_REQUIRE_EQUAL((small.ore<SDRElem<>, std::vector<SDRElem<>>>(large)), (SDR{5, 99, 110}));
+  BOOST_REQUIRE_EQUAL(small.ors(large), 3);
+  BOOST_REQUIRE_EQUAL(large.rme(small), (SDR{110}));
+}
+
+BOOST_AUTO_TEST_CASE(roaring_container) {
+  using R = SDR<SDRElem<>, RoaringContainer<SDRElem<>>>;
+  auto container = [](R& r) -> RoaringContainer<SDRElem<>>& { return reinterpret_cast<RoaringContainer<SDRElem<>>&>(r); };
+  std::mt19937 twister(1234);
+  // sparse ids everywhere, a dense chunk, and some long runs
+  auto make = [&]() {
+    std::set<int> ids;
+    for (int i = 0; i < 300; ++i) ids.insert(static_cast<int>(twister()));
+    for (int i = 0x10000; i < 0x20000; ++i) {
+      if (twister() % 4 == 0) ids.insert(i);
+    }
+    for (int run = 0; run < 5; ++run) {
+      int start = -0x30000 + static_cast<int>(twister() % 0x20000);
+      for (int i = start; i < start + 3000; ++i) ids.insert(i);
+    }
+    R r;
+    for (int id : ids) r.push_back(id);
+    return r;
+  };
+  for (int trial = 0; trial < 4; ++trial) {
+    R a = make();
+    R b = make();
+    if (trial & 1) container(a).optimize();
+    if (trial & 2) container(b).optimize();
+    SDR a_vec(a.cbegin(), a.cend());
+    SDR b_vec(b.cbegin(), b.cend());
+    BOOST_REQUIRE_EQUAL(a.size(), a_vec.size());
+    BOOST_REQUIRE_EQUAL(a, a_vec);
+    // chunk-wise
+    BOOST_REQUIRE_EQUAL(a.ande(b), a_vec.ande(b_vec));
+    BOOST_REQUIRE_EQUAL(a.ore(b), a_vec.ore(b_vec));
+    BOOST_REQUIRE_EQUAL(a.xore(b), a_vec.xore(b_vec));
+    BOOST_REQUIRE_EQUAL(a.rme(b), a_vec.rme(b_vec));
+    BOOST_REQUIRE_EQUAL(a.ands(b), a_vec.ands(b_vec));
+    BOOST_REQUIRE_EQUAL(a.ors(b), a_vec.ors(b_vec));
+    BOOST_REQUIRE_EQUAL(a.xors(b), a_vec.xors(b_vec));
+    BOOST_REQUIRE_EQUAL(a.rms(b), a_vec.rms(b_vec));
+    BOOST_REQUIRE_EQUAL(R(a).andi(b), a_vec.ande(b_vec));
+    BOOST_REQUIRE_EQUAL(R(a).ori(b), a_vec.ore(b_vec));
+    BOOST_REQUIRE_EQUAL(R(a).xori(b), a_vec.xore(b_vec));
+    BOOST_REQUIRE_EQUAL(R(a).rmi(b), a_vec.rme(b_vec));
+    BOOST_REQUIRE_EQUAL(R(a).ori(R(b)), a_vec.ore(b_vec)); // rvalue
+    // mixed with other containers
+    BOOST_REQUIRE_EQUAL(a.ande(b_vec), a_vec.ande(b_vec));
+    BOOST_REQUIRE_EQUAL(a_vec.ande(b), a_vec.ande(b_vec));
+    BOOST_REQUIRE_EQUAL(R(a).andi(b_vec), a_vec.ande(b_vec));
+    BOOST_REQUIRE_EQUAL(R(a).ori(b_vec), a_vec.ore(b_vec));
+    BOOST_REQUIRE_EQUAL(R(a).rmi(b_vec), a_vec.rme(b_vec));
+    // reverse iteration
+    std::vector<SDRElem<>> reversed(std::make_reverse_iterator(a.cend()), std::make_reverse_iterator(a.cbegin()));
+    std::vector<SDRElem<>> expected(a_vec.cbegin(), a_vec.cend());
+    BOOST_REQUIRE(std::equal(reversed.begin(), reversed.end(), expected.rbegin(), expected.rend()));
+  }
+  // a dense chunk is smaller than a list of ids
+  R dense;
+  for (int i = 0; i < 0x10000; i += 2) dense.push_back(i);
+  BOOST_REQUIRE(container(dense).chunks().front().kind == roaring_container_objs::ChunkKind::bitmap);
+  BOOST_REQUIRE_LT(container(dense).memory_usage(), dense.size() * sizeof(int) / 2);
+  // erasing keeps the other iterators valid
+  R c{-5, 1, 2, 3, 70000, 70001};
+  container(c).optimize();
+  auto it = c.cbegin();
+  ++it;
+  auto next = std::next(it);
+  c.erase(it);
+  BOOST_REQUIRE_EQUAL(*next, SDRElem<>(2));
+  BOOST_REQUIRE_EQUAL(*++next, SDRElem<>(3));
+  BOOST_REQUIRE_EQUAL(*++next, SDRElem<>(70000));
+  BOOST_REQUIRE_EQUAL(c, (SDR{-5, 2, 3, 70000, 70001}));
+  BOOST_REQUIRE_NE(c & 70001, nullptr);
+  BOOST_REQUIRE_EQUAL(c & 4, nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(compressed_container) {
+  using C = SDR<SDRElem<>, CompressedContainer<SDRElem<>>>;
+  auto container = [](const C& c) -> const CompressedContainer<SDRElem<>>& { return reinterpret_cast<const CompressedContainer<SDRElem<>>&>(c); };
+  std::mt19937 twister(2468);
+  for (int trial = 0; trial < 20; ++trial) {
+    C a;
+    C b;
+    SDR a_vec;
+    SDR b_vec;
+    // negative ids, small gaps, and large gaps
+    for (int i = -2000; i < 2000; ++i) {
+      if (twister() % 7 == 0) {
+        a.push_back(i);
+        a_vec.push_back(i);
+      }
+      if (twister() % 3 == 0) {
+        b.push_back(i);
+        b_vec.push_back(i);
+      }
+    }
+    a.push_back(1 << 30);
+    a_vec.push_back(1 << 30);
+    BOOST_REQUIRE_EQUAL(a, a_vec);
+    BOOST_REQUIRE_EQUAL(a.size(), a_vec.size());
+    BOOST_REQUIRE_EQUAL(a.ande(b), a_vec.ande(b_vec));
+    BOOST_REQUIRE_EQUAL(a.ore(b), a_vec.ore(b_vec));
+    BOOST_REQUIRE_EQUAL(a.xore(b), a_vec.xore(b_vec));
+    BOOST_REQUIRE_EQUAL(a.rme(b), a_vec.rme(b_vec));
+    BOOST_REQUIRE_EQUAL(a.ands(b), a_vec.ands(b_vec));
+    BOOST_REQUIRE_EQUAL(a.ors(b), a_vec.ors(b_vec));
+    BOOST_REQUIRE_EQUAL(a.xors(b), a_vec.xors(b_vec));
+    BOOST_REQUIRE_EQUAL(a.rms(b), a_vec.rms(b_vec));
+    BOOST_REQUIRE_EQUAL(C(a).andi(b), a_vec.ande(b_vec));
+    BOOST_REQUIRE_EQUAL(C(a).ori(b), a_vec.ore(b_vec));
+    BOOST_REQUIRE_EQUAL(C(a).ori(C(b)), a_vec.ore(b_vec)); // rvalue
+    BOOST_REQUIRE_EQUAL(C(a).xori(b), a_vec.xore(b_vec));
+    BOOST_REQUIRE_EQUAL(C(a).rmi(b), a_vec.rme(b_vec));
+    // mixed with other containers
+    BOOST_REQUIRE_EQUAL(a.ande(b_vec), a_vec.ande(b_vec));
+    BOOST_REQUIRE_EQUAL(a_vec.ande(b), a_vec.ande(b_vec));
+    BOOST_REQUIRE_EQUAL(a_vec.ands(b), a_vec.ands(b_vec));
+    BOOST_REQUIRE_EQUAL(SDR(a_vec).andi(b), a_vec.ande(b_vec));
+    BOOST_REQUIRE_EQUAL(SDR(a_vec).rmi(b), a_vec.rme(b_vec));
+    BOOST_REQUIRE_EQUAL(C(a).ori(b_vec), a_vec.ore(b_vec));
+    BOOST_REQUIRE_EQUAL(a.ande(-1000, 1000), a_vec.ande(-1000, 1000));
+    BOOST_REQUIRE_EQUAL(a.ands(-1000, 1000), a_vec.ands(-1000, 1000));
+    // reverse iteration
+    std::vector<SDRElem<>> reversed(std::make_reverse_iterator(a.cend()), std::make_reverse_iterator(a.cbegin()));
+    std::vector<SDRElem<>> expected(a_vec.cbegin(), a_vec.cend());
+    BOOST_REQUIRE(std::equal(reversed.begin(), reversed.end(), expected.rbegin(), expected.rend()));
+  }
+  // the first id is stored in full, and close together ids after it take a byte each
+  C dense;
+  for (int i = 0; i < 10000; i += 3) dense.push_back(i);
+  BOOST_REQUIRE_EQUAL(container(dense).encoded().size(), dense.size() - 1 + 5);
+  BOOST_REQUIRE_NE(dense & 9999, nullptr);
+  BOOST_REQUIRE_EQUAL(dense & 9998, nullptr);
+  BOOST_REQUIRE_EQUAL(*container(dense).lower_bound(5000), SDRElem<>(5001));
+  BOOST_REQUIRE(container(dense).lower_bound(10000) == container(dense).end());
+}
+
+BOOST_AUTO_TEST_CASE(run_container) {
+  using C = SDR<SDRElem<>, RunContainer<SDRElem<>>>;
+  auto container = [](const C& c) -> const RunContainer<SDRElem<>>& { return reinterpret_cast<const RunContainer<SDRElem<>>&>(c); };
+  std::mt19937 twister(1357);
+  for (int trial = 0; trial < 20; ++trial) {
+    C a;
+    C b;
+    SDR a_vec;
+    SDR b_vec;
+    // runs of random lengths, and negative ids
+    bool in_a = false;
+    bool in_b = false;
+    for (int i = -2000; i < 2000; ++i) {
+      if (twister() % 16 == 0) in_a = !in_a;
+      if (twister() % 4 == 0) in_b = !in_b;
+      if (in_a) {
+        a.push_back(i);
+        a_vec.push_back(i);
+      }
+      if (in_b) {
+        b.push_back(i);
+        b_vec.push_back(i);
+      }
+    }
+    BOOST_REQUIRE_EQUAL(a, a_vec);
+    BOOST_REQUIRE_EQUAL(a.size(), a_vec.size());
+    BOOST_REQUIRE_EQUAL(a.ande(b), a_vec.ande(b_vec));
+    BOOST_REQUIRE_EQUAL(a.ore(b), a_vec.ore(b_vec));
+    BOOST_REQUIRE_EQUAL(a.xore(b), a_vec.xore(b_vec));
+    BOOST_REQUIRE_EQUAL(a.rme(b), a_vec.rme(b_vec));
+    BOOST_REQUIRE_EQUAL(a.ands(b), a_vec.ands(b_vec));
+    BOOST_REQUIRE_EQUAL(a.ors(b), a_vec.ors(b_vec));
+    BOOST_REQUIRE_EQUAL(a.xors(b), a_vec.xors(b_vec));
+    BOOST_REQUIRE_EQUAL(a.rms(b), a_vec.rms(b_vec));
+    BOOST_REQUIRE_EQUAL(C(a).andi(b), a_vec.ande(b_vec));
+    BOOST_REQUIRE_EQUAL(C(a).ori(b), a_vec.ore(b_vec));
+    BOOST_REQUIRE_EQUAL(C(a).ori(C(b)), a_vec.ore(b_vec)); // rvalue
+    BOOST_REQUIRE_EQUAL(C(a).xori(b), a_vec.xore(b_vec));
+    BOOST_REQUIRE_EQUAL(C(a).rmi(b), a_vec.rme(b_vec));
+    // run-wise into other result containers
+    BOOST_REQUIRE_EQUAL((a.ore<SDRElem<>, std::vector<SDRElem<>>>(b)), a_vec.ore(b_vec));
+    BOOST_REQUIRE_EQUAL((a.xore<SDRElem<>, std::forward_list<SDRElem<>>>(b)), a_vec.xore(b_vec));
+    // mixed with other containers, which inserts and erases within runs
+    BOOST_REQUIRE_EQUAL(a.ande(b_vec), a_vec.ande(b_vec));
+    BOOST_REQUIRE_EQUAL(a_vec.ande(b), a_vec.ande(b_vec));
+    BOOST_REQUIRE_EQUAL(C(a).andi(b_vec), a_vec.ande(b_vec));
+    BOOST_REQUIRE_EQUAL(C(a).ori(b_vec), a_vec.ore(b_vec));
+    BOOST_REQUIRE_EQUAL(C(a).xori(b_vec), a_vec.xore(b_vec));
+    BOOST_REQUIRE_EQUAL(C(a).rmi(b_vec), a_vec.rme(b_vec));
+    BOOST_REQUIRE_EQUAL(a.ande(-1000, 1000), a_vec.ande(-1000, 1000));
+    BOOST_REQUIRE_EQUAL(a.ands(-1000, 1000), a_vec.ands(-1000, 1000));
+    // reverse iteration
+    std::vector<SDRElem<>> reversed(std::make_reverse_iterator(a.cend()), std::make_reverse_iterator(a.cbegin()));
+    std::vector<SDRElem<>> expected(a_vec.cbegin(), a_vec.cend());
+    BOOST_REQUIRE(std::equal(reversed.begin(), reversed.end(), expected.rbegin(), expected.rend()));
+  }
+  // the encoders emit runs directly
+  for (float input : {0.0f, 0.3f, 0.5f, 1.0f}) {
+    C enc(input, 50, 1000);
+    BOOST_REQUIRE_EQUAL(enc, SDR<>(input, 50, 1000));
+    BOOST_REQUIRE_EQUAL(container(enc).runs().size(), 1);
+    C periodic(input, 0.6f, 300, 1000);
+    BOOST_REQUIRE_EQUAL(periodic, SDR<>(input, 0.6f, 300, 1000));
+    BOOST_REQUIRE_LE(container(periodic).runs().size(), 2);
+  }
+  C x(0.25f, 100, 1000);
+  C y(0.3f, 100, 1000);
+  BOOST_REQUIRE_EQUAL(x.ands(y), SDR<>(0.25f, 100, 1000).ands(SDR<>(0.3f, 100, 1000)));
+  BOOST_REQUIRE_EQUAL(container(x.xore(y)).runs().size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(inline_container) {
+  using C = SDR<SDRElem<>, InlineContainer<SDRElem<>, 40>>;
+  auto container = [](const C& c) -> const InlineContainer<SDRElem<>, 40>& { return reinterpret_cast<const InlineContainer<SDRElem<>, 40>&>(c); };
+  static_assert(C::uses_vector_like);
+  std::mt19937 twister(9753);
+  for (int trial = 0; trial < 40; ++trial) {
+    C a;
+    C b;
+    SDR a_vec;
+    SDR b_vec;
+    // some trials spill past the inline capacity
+    int spread = trial % 2 == 0 ? 500 : 5000;
+    for (int i = 0; i < 1000; ++i) {
+      if (twister() % spread < 20) {
+        a.push_back(i);
+        a_vec.push_back(i);
+      }
+      if (twister() % spread < 20) {
+        b.push_back(i);
+        b_vec.push_back(i);
+      }
+    }
+    BOOST_REQUIRE_EQUAL(a, a_vec);
+    BOOST_REQUIRE_EQUAL(container(a).is_inline(), a.size() <= 40);
+    BOOST_REQUIRE_EQUAL(a.ande(b), a_vec.ande(b_vec));
+    BOOST_REQUIRE_EQUAL(a.ore(b), a_vec.ore(b_vec));
+    BOOST_REQUIRE_EQUAL(a.xore(b), a_vec.xore(b_vec));
+    BOOST_REQUIRE_EQUAL(a.rme(b), a_vec.rme(b_vec));
+    BOOST_REQUIRE_EQUAL(a.ands(b), a_vec.ands(b_vec));
+    BOOST_REQUIRE_EQUAL(a.ors(b), a_vec.ors(b_vec));
+    BOOST_REQUIRE_EQUAL(a.xors(b), a_vec.xors(b_vec));
+    BOOST_REQUIRE_EQUAL(a.rms(b), a_vec.rms(b_vec));
+    BOOST_REQUIRE_EQUAL(C(a).andi(b), a_vec.ande(b_vec));
+    BOOST_REQUIRE_EQUAL(C(a).ori(b), a_vec.ore(b_vec));
+    BOOST_REQUIRE_EQUAL(C(a).ori(C(b)), a_vec.ore(b_vec)); // rvalue
+    BOOST_REQUIRE_EQUAL(C(a).xori(b), a_vec.xore(b_vec));
+    BOOST_REQUIRE_EQUAL(C(a).rmi(b), a_vec.rme(b_vec));
+    BOOST_REQUIRE_EQUAL(a.ande(b_vec), a_vec.ande(b_vec));
+    BOOST_REQUIRE_EQUAL(SDR(a_vec).ori(b), a_vec.ore(b_vec));
+    // a result which fits is moved back within the container
+    auto r = a.ande(b);
+    BOOST_REQUIRE(container(r).is_inline());
+    // copy and move, inline and allocated
+    C copied(a);
+    BOOST_REQUIRE_EQUAL(copied, a_vec);
+    C moved(std::move(copied));
+    BOOST_REQUIRE_EQUAL(moved, a_vec);
+    copied = moved;
+    BOOST_REQUIRE_EQUAL(copied, a_vec);
+    moved = std::move(b);
+    BOOST_REQUIRE_EQUAL(moved, b_vec);
+  }
+  // elements with data
+  SDR<SDRElem<int, UnitData>, InlineContainer<SDRElem<int, UnitData>, 4>> d{SDRElem<int, UnitData>(1, UnitData(0.5)), SDRElem<int, UnitData>(2, UnitData(0.25))};
+  SDR<SDRElem<int, UnitData>> d_vec{SDRElem<int, UnitData>(1, UnitData(0.5)), SDRElem<int, UnitData>(2, UnitData(0.25))};
+  SDR<SDRElem<int, UnitData>> e{SDRElem<int, UnitData>(2, UnitData(0.5)), SDRElem<int, UnitData>(3, UnitData(0.5))};
+  BOOST_REQUIRE_EQUAL(d.ande(e), d_vec.ande(e));
+  BOOST_REQUIRE_EQUAL(d.ore(e), d_vec.ore(e));
+  d.insert(d.begin(), SDRElem<int, UnitData>(0, UnitData(1)));
+  BOOST_REQUIRE_EQUAL(d.begin()->id(), 0);
+  BOOST_REQUIRE_EQUAL(d.size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(overlap_stats) {
+  std::mt19937 twister(4321);
+  auto check = [](const auto& a, const auto& b) {
+    auto stats = a.overlap_stats(b);
+    BOOST_REQUIRE_EQUAL(stats.a_size, a.size());
+    BOOST_REQUIRE_EQUAL(stats.b_size, b.size());
+    BOOST_REQUIRE_EQUAL(stats.ands, a.ands(b));
+    BOOST_REQUIRE_EQUAL(stats.ors, a.ors(b));
+    BOOST_REQUIRE_EQUAL(stats.xors, a.xors(b));
+    BOOST_REQUIRE_EQUAL(stats.rms, a.rms(b));
+  };
+  for (int trial = 0; trial < 20; ++trial) {
+    SDR a;
+    SDR b;
+    SDR<SDRElem<int, UnitData>> a_data;
+    SDR<SDRElem<int, UnitData>> b_data;
+    for (int i = 0; i < 1000; ++i) {
+      if (twister() % 4 == 0) {
+        a.push_back(i);
+        a_data.push_back(SDRElem<int, UnitData>(i, UnitData((twister() % 100) / 100.0f)));
+      }
+      if (twister() % 3 == 0) {
+        b.push_back(i);
+        b_data.push_back(SDRElem<int, UnitData>(i, UnitData((twister() % 100) / 100.0f)));
+      }
+    }
+    check(a, b);
+    check(a_data, b_data); // relevance of the data
+    check(a_data, b);
+    check(SDR<SDRElem<>, std::set<SDRElem<>, std::less<>>>(a.begin(), a.end()), b);
+    check(SDR<SDRElem<>, std::forward_list<SDRElem<>>>(a.begin(), a.end()), b);
+    check(SDR<SDRElem<>, BitsetContainer<SDRElem<>, 1000>>(a.begin(), a.end()), SDR<SDRElem<>, BitsetContainer<SDRElem<>, 1000>>(b.begin(), b.end()));
+  }
+  // |a| = 4, |b| = 2, |a and b| = 2
+  auto stats = SDR{1, 2, 3, 4}.overlap_stats(SDR{2, 4});
+  BOOST_REQUIRE_CLOSE(stats.jaccard(), 2.0 / 4, 1e-9);
+  BOOST_REQUIRE_CLOSE(stats.dice(), 2.0 * 2 / 6, 1e-9);
+  BOOST_REQUIRE_CLOSE(stats.cosine(), 2.0 / std::sqrt(8.0), 1e-9);
+  auto empty = SDR().overlap_stats(SDR());
+  BOOST_REQUIRE_EQUAL(empty.jaccard(), 0);
+  BOOST_REQUIRE_EQUAL(empty.dice(), 0);
+  BOOST_REQUIRE_EQUAL(empty.cosine(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(nary_ore) {
+  std::mt19937 twister(1122);
+  std::vector<SDR<>> sdrs;
+  std::vector<SDR<SDRElem<int, UnitData>>> data_sdrs;
+  for (int i = 0; i < 50; ++i) {
+    SDR<> sdr;
+    SDR<SDRElem<int, UnitData>> data_sdr;
+    for (int id = 0; id < 500; ++id) {
+      if (twister() % 40 == 0) {
+        sdr.push_back(id);
+        data_sdr.push_back(SDRElem<int, UnitData>(id, UnitData((twister() % 100) / 100.0f)));
+      }
+    }
+    sdrs.push_back(std::move(sdr));
+    data_sdrs.push_back(std::move(data_sdr));
+  }
+  SDR<> chained;
+  SDR<SDRElem<int, UnitData>> data_chained;
+  for (std::size_t i = 0; i < sdrs.size(); ++i) {
+    chained.ori(sdrs[i]);
+    data_chained.ori(data_sdrs[i]);
+  }
+  BOOST_REQUIRE_EQUAL(ore(sdrs), chained);
+  BOOST_REQUIRE_EQUAL(ore(data_sdrs), data_chained);
+  // pointers, and other containers
+  std::vector<SDR<SDRElem<>, std::set<SDRElem<>, std::less<>>>> sets;
+  for (const auto& sdr : sdrs) sets.emplace_back(sdr.begin(), sdr.end());
+  std::vector<const SDR<SDRElem<>, std::set<SDRElem<>, std::less<>>>*> set_ptrs;
+  for (const auto& sdr : sets) set_ptrs.push_back(&sdr);
+  BOOST_REQUIRE_EQUAL(ore(set_ptrs), chained);
+  auto flist_result = ore<SDRElem<>, std::forward_list<SDRElem<>>>(set_ptrs);
+  BOOST_REQUIRE_EQUAL(flist_result, chained);
+  BOOST_REQUIRE_EQUAL(flist_result.size(), chained.size());
+  std::vector<std::reference_wrapper<const SDR<>>> refs{std::cref(sdrs[0]), std::cref(sdrs[1])};
+  BOOST_REQUIRE_EQUAL(ore(refs), sdrs[0].ore(sdrs[1]));
+  BOOST_REQUIRE_EQUAL(ore(std::vector<SDR<>>()), SDR<>());
+  BOOST_REQUIRE_EQUAL(ore(std::vector<SDR<>>{SDR<>{1, 2}}), (SDR<>{1, 2}));
+  // a range of mixed SDR types isn't a range of SDRs (ore static_asserts), so they're converted to one type first
+  using Mixed = std::variant<SDR<>, SDR<SDRElem<>, std::set<SDRElem<>, std::less<>>>>;
+  static_assert(!is_sdr<nary_ops::sdr_type<std::vector<Mixed>>>::value);
+  std::vector<SDR<>> converted{SDR<>(sets[0].begin(), sets[0].end()), sdrs[1]};
+  BOOST_REQUIRE_EQUAL(ore(converted), sdrs[0].ore(sdrs[1]));
+}
+
+BOOST_AUTO_TEST_CASE(nary_ande) {
+  std::mt19937 twister(3344);
+  for (int trial = 0; trial < 20; ++trial) {
+    std::vector<SDR<>> sdrs;
+    std::vector<SDR<SDRElem<int, UnitData>>> data_sdrs;
+    // one small SDR and many large ones
+    for (int i = 0; i < 10; ++i) {
+      SDR<> sdr;
+      SDR<SDRElem<int, UnitData>> data_sdr;
+      unsigned keep = i == 3 ? 20 : 2;
+      for (int id = 0; id < 2000; ++id) {
+        if (twister() % keep == 0) {
+          sdr.push_back(id);
+          data_sdr.push_back(SDRElem<int, UnitData>(id, UnitData(0.5f + (twister() % 50) / 100.0f)));
+        }
+      }
+      sdrs.push_back(std::move(sdr));
+      data_sdrs.push_back(std::move(data_sdr));
+    }
+    SDR<> chained = sdrs[0];
+    SDR<SDRElem<int, UnitData>> data_chained = data_sdrs[0];
+    for (std::size_t i = 1; i < sdrs.size(); ++i) {
+      chained.andi(sdrs[i]);
+      data_chained.andi(data_sdrs[i]);
+    }
+    BOOST_REQUIRE_EQUAL(ande(sdrs), chained);
+    BOOST_REQUIRE_EQUAL(ands(sdrs), chained.size());
+    BOOST_REQUIRE_EQUAL(ande(data_sdrs), data_chained);
+    BOOST_REQUIRE_EQUAL(ands(data_sdrs), data_chained.size());
+    // searching sets and linear flists
+    std::vector<SDR<SDRElem<>, std::set<SDRElem<>, std::less<>>>> sets;
+    std::vector<SDR<SDRElem<>, std::forward_list<SDRElem<>>>> flists;
+    for (const auto& sdr : sdrs) {
+      sets.emplace_back(sdr.begin(), sdr.end());
+      flists.emplace_back(sdr.begin(), sdr.end());
+    }
+    BOOST_REQUIRE_EQUAL(ande(sets), chained);
+    BOOST_REQUIRE_EQUAL(ands(flists), chained.size());
+    BOOST_REQUIRE_EQUAL((ande<SDRElem<>, std::forward_list<SDRElem<>>>(flists)), chained);
+  }
+  BOOST_REQUIRE_EQUAL(ande(std::vector<SDR<>>()), SDR<>());
+  BOOST_REQUIRE_EQUAL(ands(std::vector<SDR<>>{SDR<>{1, 2}, SDR<>()}), 0);
+  BOOST_REQUIRE_EQUAL(ande(std::vector<SDR<>>{SDR<>{1, 2, 5}, SDR<>{0, 2, 5, 9}}), (SDR<>{2, 5}));
+}
+
+BOOST_AUTO_TEST_CASE(nary_vote) {
+  std::mt19937 twister(5566);
+  std::vector<SDR<SDRElem<int, UnitData>>> sdrs;
+  std::map<int, std::pair<std::size_t, float>> counts; // id -> (count, max value)
+  for (int i = 0; i < 30; ++i) {
+    SDR<SDRElem<int, UnitData>> sdr;
+    for (int id = 0; id < 300; ++id) {
+      if (twister() % 4 == 0) {
+        float value = 0.1f + (twister() % 90) / 100.0f;
+        sdr.push_back(SDRElem<int, UnitData>(id, UnitData(value)));
+        auto& c = counts[id];
+        ++c.first;
+        c.second = std::max(c.second, value);
+      }
+    }
+    sdrs.push_back(std::move(sdr));
+  }
+  for (std::size_t k : {1, 5, 8, 10, 30, 31}) {
+    SDR<SDRElem<int, UnitData>> expected;
+    for (const auto& [id, c] : counts) {
+      if (c.first >= k) expected.push_back(SDRElem<int, UnitData>(id, UnitData(c.second)));
+    }
+    auto result = vote(sdrs, k);
+    BOOST_REQUIRE_EQUAL(result, expected);
+    BOOST_REQUIRE_EQUAL(votes(sdrs, k), expected.size());
+  }
+  BOOST_REQUIRE_EQUAL(vote(sdrs, 1), ore(sdrs));
+  std::vector<SDR<SDRElem<>, std::forward_list<SDRElem<>>>> flists{{1, 2, 3}, {2, 3}, {3, 4}};
+  BOOST_REQUIRE_EQUAL(vote(flists, 2), (SDR<>{2, 3}));
+  BOOST_REQUIRE_EQUAL(vote(flists, 2).size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(inverted_index) {
+  std::mt19937 twister(7788);
+  std::map<std::size_t, SDR<>> stored;
+  InvertedIndex<> index;
+  auto random_sdr = [&](int density) {
+    SDR<> sdr;
+    for (int id = 0; id < 200; ++id) {
+      if (twister() % density == 0) sdr.push_back(id);
+    }
+    return sdr;
+  };
+  for (std::size_t key = 0; key < 400; ++key) {
+    stored[key] = random_sdr(key % 2 ? 4 : 12);
+    index.insert(key, stored[key]);
+  }
+  auto brute_force = [&](const SDR<>& query, std::size_t k, std::size_t min_overlap) {
+    std::vector<InvertedIndex<>::Match> r;
+    for (const auto& [key, sdr] : stored) {
+      std::size_t overlap = query.ands(sdr);
+      if (overlap >= std::max<std::size_t>(min_overlap, 1)) r.push_back({key, overlap});
+    }
+    std::sort(r.begin(), r.end(), [](const auto& a, const auto& b) { return a.overlap > b.overlap || (a.overlap == b.overlap && a.key < b.key); });
+    if (r.size() > k) r.resize(k);
+    return r;
+  };
+  for (std::size_t round = 0; round < 3; ++round) {
+    for (int i = 0; i < 40; ++i) {
+      SDR<> query = random_sdr(1 + i % 6);
+      for (std::size_t k : {1, 3, 10, 1000}) {
+        for (std::size_t min_overlap : {0, 5, 30}) {
+          BOOST_REQUIRE(index.top_k(query, k, min_overlap) == brute_force(query, k, min_overlap));
+        }
+      }
+      BOOST_REQUIRE_EQUAL(index.overlap(query, stored.begin()->first), query.ands(stored.begin()->second));
+    }
+    // incremental changes
+    for (std::size_t key = round; key < 400; key += 3) {
+      BOOST_REQUIRE(index.erase(key));
+      stored.erase(key);
+    }
+    for (std::size_t key = 400 + round * 50; key < 450 + round * 50; ++key) {
+      stored[key] = random_sdr(3);
+      SDR<SDRElem<>, std::set<SDRElem<>, std::less<>>> as_set(stored[key].begin(), stored[key].end());
+      index.insert(key, as_set.cbegin(), as_set.cend());
+    }
+    BOOST_REQUIRE_EQUAL(index.size(), stored.size());
+  }
+  BOOST_REQUIRE(!index.erase(0));
+  BOOST_REQUIRE(!index.contains(0));
+  index.insert(1, SDR<>{1, 2, 3}); // replaces
+  BOOST_REQUIRE(index.top_k(SDR<>{1, 2, 3}, 1) == (std::vector<InvertedIndex<>::Match>{{1, 3}}));
+  BOOST_REQUIRE(index.top_k(SDR<>{1, 2, 3}, 0).empty());
+  index.clear();
+  BOOST_REQUIRE(index.top_k(SDR<>{1, 2, 3}, 5).empty());
+}
+
+BOOST_AUTO_TEST_CASE(minhash_lsh) {
+  std::mt19937 twister(3344);
+  auto random_sdr = [&]() {
+    SDR<> sdr;
+    for (int id = 0; id < 2000; ++id) {
+      if (twister() % 20 == 0) sdr.push_back(id);
+    }
+    return sdr;
+  };
+  // signatures only depend on the seed
+  MinHasher hasher(128, 42);
+  SDR<> a = random_sdr();
+  SDR<SDRElem<>, std::set<SDRElem<>, std::less<>>> a_set(a.begin(), a.end());
+  BOOST_REQUIRE(hasher.signature(a) == MinHasher(128, 42).signature(a_set));
+  BOOST_REQUIRE(hasher.signature(a) != MinHasher(128, 43).signature(a));
+  BOOST_REQUIRE_EQUAL(MinHasher::similarity(hasher.signature(a), hasher.signature(a)), 1);
+  // estimate of the jaccard similarity
+  SDR<> b = a;
+  for (int i = 0; i < 40; ++i) b.ori(SDR<>{static_cast<int>(twister() % 2000)});
+  double jaccard = a.overlap_stats(b).jaccard();
+  BOOST_REQUIRE_CLOSE(MinHasher::similarity(hasher.signature(a), hasher.signature(b)), jaccard, 20);
+
+  // near duplicates of the query are found, and ranked by exact overlap
+  std::map<std::size_t, SDR<>> stored;
+  LSHIndex<> index(16, 4, 7);
+  for (std::size_t key = 0; key < 200; ++key) {
+    stored[key] = random_sdr();
+    index.insert(key, stored[key]);
+  }
+  SDR<> query = random_sdr();
+  stored[1000] = query;
+  stored[1001] = query;
+  stored[1001].erase(stored[1001].cbegin());
+  for (std::size_t key : {1001, 1000}) index.insert(key, stored[key]);
+  auto lookup = [&](std::size_t key) -> const SDR<>& { return stored.at(key); };
+  auto matches = index.top_k(query, 2, lookup);
+  BOOST_REQUIRE(matches == (std::vector<LSHIndex<>::Match>{{1000, query.size()}, {1001, query.size() - 1}}));
+  auto candidates = index.candidates(query);
+  BOOST_REQUIRE(candidates.size() < stored.size());
+  BOOST_REQUIRE_EQUAL(std::set<std::size_t>(candidates.begin(), candidates.end()).size(), candidates.size());
+  // persisted signatures give the same candidates
+  LSHIndex<> restored(16, 4, 7);
+  for (const auto& [key, sdr] : stored) restored.insert(key, *index.signature(key));
+  auto restored_candidates = restored.candidates(query);
+  BOOST_REQUIRE(std::set<std::size_t>(restored_candidates.begin(), restored_candidates.end()) == std::set<std::size_t>(candidates.begin(), candidates.end()));
+  BOOST_REQUIRE(index.erase(1000));
+  BOOST_REQUIRE(!index.erase(1000));
+  BOOST_REQUIRE(index.top_k(query, 1, lookup) == (std::vector<LSHIndex<>::Match>{{1001, query.size() - 1}}));
+  BOOST_REQUIRE_EQUAL(index.size(), 201);
+}
+
+BOOST_AUTO_TEST_CASE(pairwise_overlap) {
+  std::mt19937 twister(1122);
+  std::vector<SDR<>> sdrs(50);
+  for (auto& sdr : sdrs) {
+    for (int id = 0; id < 100; ++id) {
+      if (twister() % 8 == 0) sdr.push_back(id);
+    }
+  }
+  sdrs[7].clear(); // no overlap with anything
+  const std::size_t n = sdrs.size();
+  std::vector<std::size_t> expected(n * n);
+  for (std::size_t i = 0; i < n; ++i) {
+    for (std::size_t j = 0; j < n; ++j) expected[i * n + j] = sdrs[i].ands(sdrs[j]);
+  }
+  // tiles that don't divide n, one tile per SDR, and a single tile
+  for (std::size_t tile : {7, 1, 64}) {
+    for (unsigned threads : {1, 4}) {
+      std::vector<std::size_t> dense(n * n, 12345);
+      overlap_matrix(sdrs, dense.data(), threads, tile);
+      BOOST_REQUIRE(dense == expected);
+
+      auto sparse = overlap_pairs(sdrs, 4, threads, tile);
+      pairwise::overlap_matrix_type expected_sparse;
+      for (std::size_t i = 0; i < n; ++i) {
+        SDR<SDRElem<int, ArithData<std::size_t>>> row;
+        for (std::size_t j = 0; j < n; ++j) {
+          if (expected[i * n + j] >= 4) row.push_back(SDRElem<int, ArithData<std::size_t>>(static_cast<int>(j), expected[i * n + j]));
+        }
+        if (!row.empty()) expected_sparse.push_back(SDRElem<int, SDR<SDRElem<int, ArithData<std::size_t>>>>(static_cast<int>(i), std::move(row)));
+      }
+      BOOST_REQUIRE(sparse == expected_sparse);
+    }
+  }
+  // pointers to SDRs, and a threshold of 0 still omits the pairs with no overlap
+  std::vector<const SDR<>*> ptrs{&sdrs[0], &sdrs[7]};
+  auto sparse = overlap_pairs(ptrs, 0);
+  BOOST_REQUIRE_EQUAL(sparse.size(), 1);
+  BOOST_REQUIRE_EQUAL(sparse.cbegin()->data().size(), 1);
+  BOOST_REQUIRE(overlap_pairs(std::vector<SDR<>>(), 1).empty());
+}
+
+BOOST_AUTO_TEST_CASE(xors_bounded) {
+  std::mt19937 twister(5566);
+  auto check = [](const auto& a, const auto& b) {
+    auto distance = a.xors(b);
+    for (std::size_t limit : {std::size_t(0), distance / 2, distance - 1, distance, distance + 1, distance * 2}) {
+      auto bounded = a.xors_bounded(b, limit);
+      if (distance <= limit) {
+        BOOST_REQUIRE_EQUAL(bounded, distance);
+      } else {
+        BOOST_REQUIRE(bounded > limit);
+      }
+    }
+  };
+  for (int trial = 0; trial < 20; ++trial) {
+    SDR a;
+    SDR b;
+    SDR<SDRElem<int, UnitData>> a_data;
+    SDR<SDRElem<int, UnitData>> b_data;
+    for (int i = 0; i < 500; ++i) {
+      if (twister() % 4 == 0) {
+        a.push_back(i);
+        a_data.push_back(SDRElem<int, UnitData>(i, UnitData((twister() % 100) / 100.0f)));
+      }
+      if (twister() % (trial % 2 ? 3 : 20) == 0) {
+        b.push_back(i);
+        b_data.push_back(SDRElem<int, UnitData>(i, UnitData((twister() % 100) / 100.0f)));
+      }
+    }
+    check(a, b);
+    check(b, a);
+    check(a_data, b_data); // relevance of the data
+    check(SDR<SDRElem<>, std::forward_list<SDRElem<>>>(a.begin(), a.end()), b);
+    check(SDR<SDRElem<>, BitsetContainer<SDRElem<>, 500>>(a.begin(), a.end()), SDR<SDRElem<>, BitsetContainer<SDRElem<>, 500>>(b.begin(), b.end()));
+  }
+  // the size difference alone exceeds the limit
+  BOOST_REQUIRE(SDR({1, 2, 3, 4, 5}).xors_bounded(SDR{1}, 3) > 3);
+  BOOST_REQUIRE_EQUAL(SDR().xors_bounded(SDR(), 0), 0);
+}
+
+BOOST_AUTO_TEST_CASE(hamming_k_nearest_search) {
+  std::mt19937 twister(7788);
+  std::vector<SDR<>> candidates(300);
+  for (auto& c : candidates) {
+    for (int id = 0; id < 200; ++id) {
+      if (twister() % 10 == 0) c.push_back(id);
+    }
+  }
+  SDR<> query = candidates[123];
+  candidates[200] = query; // a tie with candidate 123
+  for (std::size_t k : {1, 5, 300, 1000}) {
+    std::vector<hamming_search::Match> expected;
+    for (std::size_t i = 0; i < candidates.size(); ++i) expected.push_back({i, query.xors(candidates[i])});
+    std::sort(expected.begin(), expected.end(), [](const auto& a, const auto& b) { return a.distance < b.distance || (a.distance == b.distance && a.index < b.index); });
+    if (expected.size() > k) expected.resize(k);
+    BOOST_REQUIRE(hamming_k_nearest(query, candidates, k) == expected);
+  }
+  BOOST_REQUIRE(hamming_k_nearest(query, candidates, 2) == (std::vector<hamming_search::Match>{{123, 0}, {200, 0}}));
+  std::vector<const SDR<>*> ptrs{&candidates[0], &candidates[123]};
+  BOOST_REQUIRE(hamming_k_nearest(query, ptrs, 1) == (std::vector<hamming_search::Match>{{1, 0}}));
+  BOOST_REQUIRE(hamming_k_nearest(query, candidates, 0).empty());
+}
+
+BOOST_AUTO_TEST_CASE(fingerprinted_sdr) {
+  std::mt19937 twister(9900);
+  auto random_sdr = [&]() {
+    SDR<> sdr;
+    for (int id = 0; id < 300; ++id) {
+      if (twister() % 6 == 0) sdr.push_back(id);
+    }
+    return sdr;
+  };
+  for (int trial = 0; trial < 20; ++trial) {
+    SDR<> a = random_sdr();
+    SDR<> b = random_sdr();
+    FingerprintedSDR<> f(a);
+    BOOST_REQUIRE_EQUAL(f.fingerprint(), fingerprint::of(a));
+    // incremental updates match a recompute
+    f.push_back(1000);
+    f.insert(f.cbegin(), -1);
+    f.erase(std::next(f.cbegin(), static_cast<std::ptrdiff_t>(f.size() / 2)));
+    BOOST_REQUIRE_EQUAL(f.fingerprint(), fingerprint::of(f.sdr()));
+    f.erase(f.cbegin(), std::next(f.cbegin(), 3));
+    BOOST_REQUIRE_EQUAL(f.fingerprint(), fingerprint::of(f.sdr()));
+    // bulk ops recompute it
+    SDR<> before = f.sdr();
+    f.ori(b);
+    BOOST_REQUIRE_EQUAL(f.sdr(), before.ore(b));
+    BOOST_REQUIRE_EQUAL(f.fingerprint(), fingerprint::of(f.sdr()));
+    f.andi(FingerprintedSDR<>(b));
+    BOOST_REQUIRE_EQUAL(f.sdr(), b);
+    BOOST_REQUIRE_EQUAL(f.fingerprint(), fingerprint::of(b));
+    f.xori(a).rmi(SDR<>{5, 6}).shift(3);
+    BOOST_REQUIRE_EQUAL(f.sdr(), b.xore(a).rme(SDR<>{5, 6}).shift(3));
+    BOOST_REQUIRE_EQUAL(f.fingerprint(), fingerprint::of(f.sdr()));
+  }
+  // equality and hashing don't depend on the container
+  FingerprintedSDR<> a{1, 2, 3};
+  FingerprintedSDR<SDRElem<>, std::set<SDRElem<>, std::less<>>> a_set(SDR<SDRElem<>, std::set<SDRElem<>, std::less<>>>{1, 2, 3});
+  BOOST_REQUIRE(a == a_set);
+  // a duplicate doesn't grow a set, so it doesn't change the fingerprint
+  a_set.insert(a_set.cbegin(), 2);
+  BOOST_REQUIRE_EQUAL(a_set.size(), 3);
+  BOOST_REQUIRE_EQUAL(a_set.fingerprint(), a.fingerprint());
+  BOOST_REQUIRE(a == a_set);
+  BOOST_REQUIRE(a != FingerprintedSDR<>({1, 2, 4}));
+  BOOST_REQUIRE(a == SDR<>({1, 2, 3}));
+  BOOST_REQUIRE_EQUAL(std::hash<FingerprintedSDR<>>()(a), std::hash<SDR<>>()(SDR<>{1, 2, 3}));
+  // deduplication
+  std::unordered_set<FingerprintedSDR<>> seen;
+  BOOST_REQUIRE(seen.insert(a).second);
+  BOOST_REQUIRE(!seen.insert(FingerprintedSDR<>{1, 2, 3}).second);
+  BOOST_REQUIRE(seen.insert(FingerprintedSDR<>{}).second);
+  BOOST_REQUIRE_EQUAL(seen.size(), 2);
+  SDR<> released = a.release();
+  BOOST_REQUIRE_EQUAL(released, SDR<>({1, 2, 3}));
+  BOOST_REQUIRE(a.empty());
+  BOOST_REQUIRE_EQUAL(a.fingerprint(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(intern_pool) {
+  std::mt19937 twister(2468);
+  std::vector<SDR<>> patterns(10);
+  for (auto& p : patterns) {
+    for (int id = 0; id < 100; ++id) {
+      if (twister() % 5 == 0) p.push_back(id);
+    }
+  }
+  InternPool<> pool;
+  std::vector<InternPool<>::handle> stream;
+  for (int i = 0; i < 1000; ++i) {
+    stream.push_back(pool.intern(patterns[twister() % patterns.size()]));
+  }
+  BOOST_REQUIRE_EQUAL(pool.size(), patterns.size());
+  for (std::size_t i = 0; i < patterns.size(); ++i) {
+    auto h = pool.find(patterns[i]);
+    BOOST_REQUIRE(h);
+    BOOST_REQUIRE_EQUAL(*h, patterns[i]);
+    BOOST_REQUIRE(h == pool.intern(SDR<>(patterns[i])));
+    BOOST_REQUIRE_EQUAL(h->size(), patterns[i].size());
+  }
+  // handles are equal if and only if the SDRs are equal
+  for (std::size_t i = 1; i < stream.size(); ++i) {
+    BOOST_REQUIRE_EQUAL(stream[i] == stream[i - 1], stream[i].get() == stream[i - 1].get());
+  }
+  // handles key a map, e.g. for memoizing
+  std::unordered_map<InternPool<>::handle, std::size_t> counts;
+  for (const auto& h : stream) ++counts[h];
+  BOOST_REQUIRE_EQUAL(counts.size(), patterns.size());
+  BOOST_REQUIRE(!pool.find(SDR<>{1000}));
+  BOOST_REQUIRE(!InternPool<>::handle());
+  pool.clear();
+  BOOST_REQUIRE(pool.empty());
+}
+
+BOOST_AUTO_TEST_CASE(op_cache) {
+  std::mt19937 twister(1357);
+  InternPool<> pool;
+  std::vector<InternPool<>::handle> handles;
+  for (int i = 0; i < 6; ++i) {
+    SDR<> sdr;
+    for (int id = 0; id < 100; ++id) {
+      if (twister() % 4 == 0) sdr.push_back(id);
+    }
+    handles.push_back(pool.intern(std::move(sdr)));
+  }
+  for (std::size_t capacity : {0, 1, 5, 1000}) {
+    OpCache<> cache(capacity);
+    for (int i = 0; i < 500; ++i) {
+      auto a = handles[twister() % handles.size()];
+      auto b = handles[twister() % handles.size()];
+      BOOST_REQUIRE_EQUAL(cache.ands(a, b), a->ands(*b));
+      BOOST_REQUIRE_EQUAL(cache.ors(a, b), a->ors(*b));
+      BOOST_REQUIRE_EQUAL(cache.xors(a, b), a->xors(*b));
+      BOOST_REQUIRE_EQUAL(cache.rms(a, b), a->rms(*b));
+      BOOST_REQUIRE_EQUAL(cache.ande(a, b), a->ande(*b));
+      BOOST_REQUIRE_EQUAL(cache.ore(a, b), a->ore(*b));
+      BOOST_REQUIRE_EQUAL(cache.xore(a, b), a->xore(*b));
+      BOOST_REQUIRE_EQUAL(cache.rme(a, b), a->rme(*b));
+      BOOST_REQUIRE(cache.size() <= capacity);
+    }
+    BOOST_REQUIRE_EQUAL(cache.hits() + cache.misses(), 500 * 8);
+    if (capacity == 0) BOOST_REQUIRE_EQUAL(cache.hits(), 0);
+    if (capacity == 1000) BOOST_REQUIRE_EQUAL(cache.misses(), cache.size()); // nothing was evicted
+  }
+  // least recently used is evicted
+  OpCache<> cache(2);
+  cache.ands(handles[0], handles[1]);
+  cache.ands(handles[1], handles[2]);
+  cache.ands(handles[0], handles[1]); // hit, now most recent
+  cache.ands(handles[2], handles[3]); // evicts (1, 2)
+  BOOST_REQUIRE_EQUAL(cache.hits(), 1);
+  cache.ands(handles[0], handles[1]);
+  BOOST_REQUIRE_EQUAL(cache.hits(), 2);
+  cache.ands(handles[1], handles[2]);
+  BOOST_REQUIRE_EQUAL(cache.misses(), 4);
+  // results are copies, so they outlive eviction
+  for (std::size_t capacity : {0, 1}) {
+    OpCache<> small(capacity);
+    SDR<> first = small.ande(handles[0], handles[1]);
+    small.ande(handles[2], handles[3]);
+    BOOST_REQUIRE_EQUAL(first, handles[0]->ande(*handles[1]));
+  }
+  cache.reset_counters();
+  cache.clear();
+  BOOST_REQUIRE_EQUAL(cache.size(), 0);
+  BOOST_REQUIRE_EQUAL(cache.hits(), 0);
+}
+
 BOOST_AUTO_TEST_CASE(test_readme_container) {
   SDR<SDRElem<>, std::set<SDRElem<>, std::less<>>> a{1, 2, 3};
   SDR<SDRElem<>, std::forward_list<SDRElem<>>> b{4, 5, 6};
@@ -457,6 +1411,19 @@ using Row = SDRElem<unsigned int, SDR<Element>>;
 using Column = Row;
 using Matrix = SDR<Row>;
 
+// small whole number values, so the sums are exact in any order. empty rows are omitted
+Matrix random_matrix(std::mt19937& twister, unsigned rows, unsigned columns, unsigned spread = 1) {
+  Matrix m;
+  for (unsigned r = 0; r < rows; ++r) {
+    SDR<Element> row;
+    for (unsigned c = 0; c < columns; ++c) {
+      if (twister() % 3 == 0) row.push_back(Element(c * spread, static_cast<float>(twister() % 5 + 1)));
+    }
+    if (!row.empty()) m.push_back(Row(r, std::move(row)));
+  }
+  return m;
+}
+
 BOOST_AUTO_TEST_CASE(row_matrix_vector_multiply) {
   //  1 2   10   32
   //  3 4 * 11 = 74
@@ -570,6 +1537,124 @@ BOOST_AUTO_TEST_CASE(matrix_transpose) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(other_major_view_queues) {
+  using LoserQueue = matrix_utils::LoserTreeQueue<matrix_utils::row_info<Row>>;
+  using BucketQueue = matrix_utils::BucketQueue<matrix_utils::row_info<Row>>;
+  std::mt19937 twister(1234);
+  for (int trial = 0; trial < 10; ++trial) {
+    Matrix a = random_matrix(twister, 25, 25);
+    Matrix b = random_matrix(twister, 25, 25);
+    Matrix transposed = a.transpose();
+    BOOST_REQUIRE_EQUAL((a.transpose<Row, std::vector<Row>, LoserQueue>()), transposed);
+    BOOST_REQUIRE_EQUAL((a.transpose<Row, std::vector<Row>, BucketQueue>()), transposed);
+
+    Matrix product = a.same_mul(b);
+    BOOST_REQUIRE_EQUAL((a.same_mul<Row, std::vector<Row>, Row, std::vector<Row>, LoserQueue>(b)), product);
+    BOOST_REQUIRE_EQUAL((a.same_mul<Row, std::vector<Row>, Row, std::vector<Row>, BucketQueue>(b)), product);
+
+    SDR<Element> vec = a.begin()->data();
+    SDR<Element> col_product = a.col_major_mul_vec(vec);
+    BOOST_REQUIRE_EQUAL((a.col_major_mul_vec<Element, std::vector<Element>, Element, std::vector<Element>, LoserQueue>(vec)), col_product);
+    BOOST_REQUIRE_EQUAL((a.col_major_mul_vec<Element, std::vector<Element>, Element, std::vector<Element>, BucketQueue>(vec)), col_product);
+  }
+  BOOST_REQUIRE_EQUAL((Matrix().transpose<Row, std::vector<Row>, LoserQueue>()), Matrix());
+  BOOST_REQUIRE_EQUAL((Matrix().transpose<Row, std::vector<Row>, BucketQueue>()), Matrix());
+}
+
+BOOST_AUTO_TEST_CASE(counting_transpose) {
+  using SignedElement = SDRElem<int, ArithData<>>;
+  using SignedRow = SDRElem<int, SDR<SignedElement>>;
+  using SignedMatrix = SDR<SignedRow>;
+  using Merge = matrix_utils::LoserTreeQueue<matrix_utils::row_info<SignedRow>>;
+  std::mt19937 twister(4321);
+  for (int trial = 0; trial < 10; ++trial) {
+    // negative column ids, which are either compact or too spread out to count
+    int spread = trial % 2 == 0 ? 1 : 1000;
+    SignedMatrix m;
+    for (int r = -10; r < 10; ++r) {
+      SDR<SignedElement> row;
+      for (int c = -10; c < 10; ++c) {
+        if (twister() % 3 == 0) row.push_back(SignedElement(c * spread, static_cast<float>(twister() % 5 + 1)));
+      }
+      if (!row.empty()) m.push_back(SignedRow(r, std::move(row)));
+    }
+    // the same result as merging the rows
+    BOOST_REQUIRE_EQUAL(m.transpose(), (m.transpose<SignedRow, std::vector<SignedRow>, Merge>()));
+    BOOST_REQUIRE_EQUAL(m.transpose().transpose(), m);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(same_mul_accumulators) {
+  using Queue = std::priority_queue<matrix_utils::row_info<Row>>;
+  using Dense = matrix_utils::DenseAccumulator<Element>;
+  using Hash = matrix_utils::HashAccumulator<Element>;
+  std::mt19937 twister(5678);
+  for (int trial = 0; trial < 10; ++trial) {
+    Matrix a = random_matrix(twister, 20, 30);
+    Matrix b = random_matrix(twister, 30, 20, trial % 2 == 0 ? 1 : 100000);
+    Matrix product = a.same_mul(b);
+    BOOST_REQUIRE_EQUAL((a.same_mul<Row, std::vector<Row>, Row, std::vector<Row>, Queue, Dense>(b)), product);
+    BOOST_REQUIRE_EQUAL((a.same_mul<Row, std::vector<Row>, Row, std::vector<Row>, Queue, Hash>(b)), product);
+    // rows and elements in forward lists
+    using FlistRow = SDRElem<unsigned int, SDR<Element, std::forward_list<Element>>>;
+    auto flist_product = a.same_mul<Row, std::vector<Row>, FlistRow, std::forward_list<FlistRow>, Queue, Dense>(b);
+    BOOST_REQUIRE_EQUAL(flist_product, (a.same_mul<Row, std::vector<Row>, FlistRow, std::forward_list<FlistRow>>(b)));
+    BOOST_REQUIRE_EQUAL(flist_product.size(), product.size());
+  }
+  BOOST_REQUIRE_EQUAL((Matrix().same_mul<Row, std::vector<Row>, Row, std::vector<Row>, Queue, Dense>(Matrix())), Matrix());
+}
+
+BOOST_AUTO_TEST_CASE(parallel_matrix) {
+  std::mt19937 twister(2468);
+  using Dense = matrix_utils::DenseAccumulator<Element>;
+  for (unsigned threads : {1u, 4u}) {
+    Matrix a = random_matrix(twister, 50, 40);
+    Matrix b = random_matrix(twister, 40, 30);
+    SDR<Element> vec = b.begin()->data();
+    BOOST_REQUIRE_EQUAL(parallel::row_major_mul_vec(a, vec, threads), a.row_major_mul_vec(vec));
+    BOOST_REQUIRE_EQUAL(parallel::same_mul(a, b, threads), a.same_mul(b));
+    BOOST_REQUIRE_EQUAL((parallel::same_mul<Row, std::vector<Row>, Row, std::vector<Row>, Row, std::vector<Row>, Dense>(a, b, threads)), a.same_mul(b));
+    Matrix b_columns = b.transpose();
+    BOOST_REQUIRE_EQUAL(parallel::diff_mul(a, b_columns, threads), a.diff_mul(b_columns));
+    BOOST_REQUIRE_EQUAL(parallel::outer(vec, vec, threads), vec.outer(vec));
+    BOOST_REQUIRE_EQUAL(parallel::row_major_mul_vec(Matrix(), vec, threads), SDR<Element>());
+    BOOST_REQUIRE_EQUAL(parallel::same_mul(Matrix(), b, threads), Matrix());
+
+    // rows and elements in forward lists
+    using FlistRow = SDRElem<unsigned int, SDR<Element, std::forward_list<Element>>>;
+    using FlistMatrix = SDR<FlistRow, std::forward_list<FlistRow>>;
+    auto flist_outer = parallel::outer<Element, std::vector<Element>, Element, std::vector<Element>, FlistRow, std::forward_list<FlistRow>>(vec, vec, threads);
+    FlistMatrix serial_outer = vec.outer<Element, std::vector<Element>, FlistRow, std::forward_list<FlistRow>>(vec);
+    BOOST_REQUIRE_EQUAL(flist_outer, serial_outer);
+    BOOST_REQUIRE_EQUAL(flist_outer.size(), vec.size());
+    BOOST_REQUIRE_EQUAL(serial_outer.size(), vec.size());
+    BOOST_REQUIRE_EQUAL(serial_outer.begin()->data().size(), vec.size());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(counting_transpose_extreme_ids) {
+  // the id range doesn't fit in a size_t, so it can't be counted densely
+  {
+    using Id = std::uint64_t;
+    using E = SDRElem<Id, ArithData<>>;
+    using R = SDRElem<Id, SDR<E>>;
+    SDR<R> m{R(0, SDR<E>{E(0, 1.0f), E(std::numeric_limits<Id>::max(), 2.0f)}),
+             R(5, SDR<E>{E(std::numeric_limits<Id>::max(), 3.0f)})};
+    SDR<R> expected{R(0, SDR<E>{E(0, 1.0f)}),
+                    R(std::numeric_limits<Id>::max(), SDR<E>{E(0, 2.0f), E(5, 3.0f)})};
+    BOOST_REQUIRE_EQUAL(m.transpose(), expected);
+  }
+  {
+    using Id = std::int64_t;
+    using E = SDRElem<Id, ArithData<>>;
+    using R = SDRElem<Id, SDR<E>>;
+    SDR<R> m{R(0, SDR<E>{E(std::numeric_limits<Id>::min(), 1.0f), E(std::numeric_limits<Id>::max(), 2.0f)})};
+    SDR<R> expected{R(std::numeric_limits<Id>::min(), SDR<E>{E(0, 1.0f)}),
+                    R(std::numeric_limits<Id>::max(), SDR<E>{E(0, 2.0f)})};
+    BOOST_REQUIRE_EQUAL(m.transpose(), expected);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(transpose2) {
   using A_inner_elem = SDRElem<double>;
   using A_inner = SDR<A_inner_elem>;
@@ -593,6 +1678,143 @@ BOOST_AUTO_TEST_CASE(matrix_trace_and_sum) {
   static_assert(std::is_same_v<decltype(sum), ArithData<>>);
 }
 
+BOOST_AUTO_TEST_CASE(compressed_matrix) {
+  std::mt19937 twister(8642);
+  using CM = CompressedMatrix<Element>;
+  {
+    // the column range doesn't fit in a size_t, so it can't be counted densely
+    using Id = std::uint64_t;
+    using E = SDRElem<Id, ArithData<>>;
+    using R = SDRElem<Id, SDR<E>>;
+    SDR<R> extreme{R(0, SDR<E>{E(0, 1.0f), E(std::numeric_limits<Id>::max(), 2.0f)}),
+                   R(5, SDR<E>{E(std::numeric_limits<Id>::max(), 3.0f)})};
+    BOOST_REQUIRE_EQUAL(CompressedMatrix<E>(extreme).transpose().to_nested(), extreme.transpose());
+  }
+  for (int trial = 0; trial < 10; ++trial) {
+    // transposed, so the row ids are sparse (even)
+    Matrix a = random_matrix(twister, 30, 20, 2).transpose();
+    Matrix b = random_matrix(twister, 15, 30, 2).transpose();
+    CM flat_a(a);
+    BOOST_REQUIRE_EQUAL(flat_a.to_nested(), a);
+    using FlistMatrix = SDR<Row, std::forward_list<Row>>;
+    BOOST_REQUIRE_EQUAL(flat_a.to_nested<FlistMatrix>(), FlistMatrix(a.begin(), a.end()));
+
+    SDR<Element> vec;
+    for (unsigned i = 0; i < 40; ++i) {
+      if (twister() % 2 == 0) vec.push_back(Element(i, static_cast<float>(twister() % 5 + 1)));
+    }
+    BOOST_REQUIRE_EQUAL(flat_a.row_major_mul_vec(vec), a.row_major_mul_vec(vec));
+    BOOST_REQUIRE_EQUAL(flat_a.col_major_mul_vec(vec), a.col_major_mul_vec(vec));
+    BOOST_REQUIRE_EQUAL(flat_a.transpose().to_nested(), a.transpose());
+    BOOST_REQUIRE(flat_a.transpose().transpose() == flat_a);
+    // columns too spread out to count densely
+    Matrix wide = random_matrix(twister, 10, 10, 100000);
+    BOOST_REQUIRE_EQUAL(CM(wide).transpose().to_nested(), wide.transpose());
+
+    CM flat_b(b);
+    BOOST_REQUIRE_EQUAL(flat_a.same_mul(flat_b).to_nested(), a.same_mul(b));
+    // b as column major is its transpose
+    Matrix b_columns = b.transpose();
+    BOOST_REQUIRE_EQUAL(flat_a.diff_mul(CM(b_columns)).to_nested(), a.diff_mul(b_columns));
+
+    // rows are read only SDRs
+    for (const auto& row : a) {
+      auto view = flat_a.find(row.id());
+      BOOST_REQUIRE_EQUAL(view, row.data());
+      BOOST_REQUIRE_EQUAL(view.size(), row.data().size());
+      BOOST_REQUIRE_EQUAL(view.ands(vec), row.data().ands(vec));
+      BOOST_REQUIRE_EQUAL(vec.ands(view), row.data().ands(vec));
+      BOOST_REQUIRE_EQUAL(view.ors(vec), row.data().ors(vec));
+      BOOST_REQUIRE_EQUAL((view.ande<Element, std::vector<Element>>(vec)), row.data().ande(vec));
+    }
+    BOOST_REQUIRE(flat_a.find(1).empty()); // odd row ids are never stored
+  }
+  BOOST_REQUIRE(CM().empty());
+  BOOST_REQUIRE_EQUAL(CM().to_nested(), Matrix());
+  BOOST_REQUIRE(CM().transpose().empty());
+}
+
+BOOST_AUTO_TEST_CASE(pmr_results) {
+  std::pmr::monotonic_buffer_resource arena;
+  using V = SDR<SDRElem<>, std::pmr::vector<SDRElem<>>>;
+  V a(&arena);
+  V b(&arena);
+  SDR a_vec;
+  SDR b_vec;
+  for (int i = 0; i < 100; ++i) {
+    if (i % 3 == 0) {
+      a.push_back(i);
+      a_vec.push_back(i);
+    }
+    if (i % 5 == 0) {
+      b.push_back(i);
+      b_vec.push_back(i);
+    }
+  }
+  using PElement = SDRElem<unsigned int, ArithData<>>;
+  using PRowData = SDR<PElement, std::pmr::vector<PElement>>;
+  using PRow = SDRElem<unsigned int, PRowData>;
+  using PMatrix = SDR<PRow, std::pmr::vector<PRow>>;
+  //  [1 2]   [5 6]   19 22
+  //  [3 4] * [7 8] = 43 50
+  auto make_matrix = [&](float w, float x, float y, float z) {
+    PMatrix m(&arena);
+    PRowData row0(&arena);
+    row0.push_back(PElement(0, w));
+    row0.push_back(PElement(1, x));
+    PRowData row1(&arena);
+    row1.push_back(PElement(0, y));
+    row1.push_back(PElement(1, z));
+    m.push_back(PRow(0, std::move(row0)));
+    m.push_back(PRow(1, std::move(row1)));
+    return m;
+  };
+  PMatrix m0 = make_matrix(1, 2, 3, 4);
+  PMatrix m1 = make_matrix(5, 6, 7, 8);
+  PMatrix m1_transposed = make_matrix(5, 7, 6, 8);
+
+  // in place results. assigning keeps the arena
+  V i_or(&arena);
+  i_or = a;
+  V i_xor(&arena);
+  i_xor = a;
+
+  // the results must come from the arena, and not from the default resource
+  std::pmr::memory_resource* previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+  i_or.ori(b);
+  i_xor.xori(b);
+  auto r_and = a.ande(b);
+  auto r_or = a.ore(b);
+  auto r_xor = a.xore(b);
+  auto r_rm = a.rme(b);
+  auto r_range = a.ande(10, 50);
+  auto product = m0.same_mul(m1);
+  auto diff_product = m0.diff_mul(m1_transposed);
+  auto transposed = m1.transpose();
+  std::pmr::set_default_resource(previous);
+
+  for (const V* r : {&r_and, &r_or, &r_xor, &r_rm, &r_range, &i_or, &i_xor}) {
+    BOOST_REQUIRE(r->get_allocator().resource() == &arena);
+  }
+  BOOST_REQUIRE_EQUAL(i_or, a_vec.ore(b_vec));
+  BOOST_REQUIRE_EQUAL(i_xor, a_vec.xore(b_vec));
+  BOOST_REQUIRE_EQUAL(r_and, a_vec.ande(b_vec));
+  BOOST_REQUIRE_EQUAL(r_or, a_vec.ore(b_vec));
+  BOOST_REQUIRE_EQUAL(r_xor, a_vec.xore(b_vec));
+  BOOST_REQUIRE_EQUAL(r_rm, a_vec.rme(b_vec));
+  BOOST_REQUIRE_EQUAL(r_range, a_vec.ande(10, 50));
+  PMatrix expected = make_matrix(19, 22, 43, 50);
+  BOOST_REQUIRE_EQUAL(product, expected);
+  BOOST_REQUIRE_EQUAL(diff_product, expected);
+  BOOST_REQUIRE_EQUAL(transposed, m1_transposed);
+  for (const PMatrix* m : {&product, &diff_product, &transposed}) {
+    BOOST_REQUIRE(m->get_allocator().resource() == &arena);
+    for (const auto& row : *m) {
+      BOOST_REQUIRE(row.data().get_allocator().resource() == &arena);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(matrix_matrix_multiply) {
   //  [1 2]   [5 6]   19 22
   //  [3 4] * [7 8] = 43 50